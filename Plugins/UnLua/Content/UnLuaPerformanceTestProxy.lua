@@ -40,6 +40,20 @@ function UnLuaPerformanceTestProxy:ReceiveBeginPlay()
 	EndTime = Seconds()
 	Message = Message .. "\n" ..  "write FString ; " .. tostring((EndTime - StartTime) * Multiplier)
 
+	StartTime = Seconds()
+	for i=1, N do
+		local MeshTag = RawObject.MeshTag
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" ..  "read FName ; " .. tostring((EndTime - StartTime) * Multiplier)
+
+	StartTime = Seconds()
+	for i=1, N do
+		local MeshDisplayName = RawObject.MeshDisplayName
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" ..  "read FText ; " .. tostring((EndTime - StartTime) * Multiplier)
+
 	StartTime = Seconds()
 	for i=1, N do
 		local COM = RawObject.COM
@@ -70,6 +84,38 @@ function UnLuaPerformanceTestProxy:ReceiveBeginPlay()
 	EndTime = Seconds()
 	Message = Message .. "\n" ..  "write TArray<FVector> ; " .. tostring((EndTime - StartTime) * Multiplier)
 
+	StartTime = Seconds()
+	for i=1, N do
+		local MeshID, MeshName, COM = RawObject.MeshID, RawObject.MeshName, RawObject.COM
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" ..  "read int32, FString, FVector ; " .. tostring((EndTime - StartTime) * Multiplier)
+
+	local PropertyNames = { "MeshID", "MeshName", "COM" }
+	StartTime = Seconds()
+	for i=1, N do
+		local MeshID, MeshName, COM = UE4.GetProperties(RawObject, PropertyNames)
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" ..  "UE.GetProperties(int32, FString, FVector) ; " .. tostring((EndTime - StartTime) * Multiplier)
+
+	StartTime = Seconds()
+	for i=1, N do
+		RawObject.MeshID = i
+		RawObject.MeshName = "9527"
+		RawObject.COM = COM
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" ..  "write int32, FString, FVector ; " .. tostring((EndTime - StartTime) * Multiplier)
+
+	local PropertyValues = { MeshID = 1024, MeshName = "9527", COM = COM }
+	StartTime = Seconds()
+	for i=1, N do
+		UE4.SetProperties(RawObject, PropertyValues)
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" ..  "UE.SetProperties(int32, FString, FVector) ; " .. tostring((EndTime - StartTime) * Multiplier)
+
 	StartTime = Seconds()
 	for i=1, N do
 		self:NOP()
@@ -129,6 +175,14 @@ function UnLuaPerformanceTestProxy:ReceiveBeginPlay()
 	EndTime = Seconds()
 	Message = Message .. "\n" .. "bool Raycast(const FVector&, const FVector&) const ; "..tostring((EndTime - StartTime) * Multiplier)
 
+	local Rotation = UE4.FRotator(0.0, 90.0, 0.0)
+	StartTime = Seconds()
+	for i=1, N do
+		local NewLocation = self:MoveComponent(Direction, Rotation, 1.0, 0, true)
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "FVector MoveComponent(const FVector&, const FRotator&, float, int32, bool) const ; "..tostring((EndTime - StartTime) * Multiplier)
+
 	local Indices = UE4.TArray(0)
 	StartTime = Seconds()
 	for i=1, N do
@@ -193,6 +247,252 @@ function UnLuaPerformanceTestProxy:ReceiveBeginPlay()
 	EndTime = Seconds()
 	Message = Message .. "\n" .. "bool GetMeshInfo(int32&, FString&, FVector&, TArray<int32>&, TArray<FVector>&, TArray<FVector>&) const ; "..tostring((EndTime - StartTime) * Multiplier)
 
+	-- iterate the 1024 items arrays, costs below are per element
+	local Rounds = math.floor(N / Indices:Length())
+
+	StartTime = Seconds()
+	for i=1, Rounds do
+		for j=1, Indices:Length() do
+			local Index = Indices:Get(j)
+		end
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "TArray<int32>:Get(i) ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	StartTime = Seconds()
+	for i=1, Rounds do
+		for j=1, #Indices do
+			local Index = Indices[j]
+		end
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "TArray<int32>[i] ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	StartTime = Seconds()
+	for i=1, Rounds do
+		for j, Index in pairs(Indices) do
+		end
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "pairs(TArray<int32>) ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	StartTime = Seconds()
+	for i=1, Rounds do
+		for j, Index in ipairs(Indices:ToTable()) do
+		end
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "ipairs(TArray<int32>:ToTable()) ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	StartTime = Seconds()
+	for i=1, Rounds do
+		for j=1, #Positions do
+			local Position = Positions[j]
+		end
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "TArray<FVector>[i] ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	StartTime = Seconds()
+	for i=1, Rounds do
+		for j, Position in pairs(Positions) do
+		end
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "pairs(TArray<FVector>) ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	StartTime = Seconds()
+	for i=1, Rounds do
+		for j, Position in ipairs(Positions:ToTable()) do
+		end
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "ipairs(TArray<FVector>:ToTable()) ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	local IndexMap = UE4.TMap(0, 0)
+	for i=1, Indices:Length() do
+		IndexMap:Add(i, i)
+	end
+
+	StartTime = Seconds()
+	for i=1, Rounds do
+		for Key, Value in pairs(IndexMap) do
+		end
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "pairs(TMap<int32, int32>) ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	StartTime = Seconds()
+	for i=1, Rounds do
+		for Key, Value in pairs(IndexMap:ToTable()) do
+		end
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "pairs(TMap<int32, int32>:ToTable()) ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	-- bulk transfer of 100k items numeric arrays, costs below are per element
+	local NumSamples = 100000
+	local Samples = {}
+	for i=1, NumSamples do
+		Samples[i] = i * 0.5
+	end
+	local SampleArray = UE4.TArray(0.0)
+	Rounds = math.floor(N / NumSamples)
+
+	StartTime = Seconds()
+	for i=1, Rounds do
+		SampleArray:FromTable(Samples)
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "TArray<float>:FromTable(table) with 100k items ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	StartTime = Seconds()
+	for i=1, Rounds do
+		local Table = SampleArray:ToTable()
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "TArray<float>:ToTable() with 100k items ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	StartTime = Seconds()
+	for i=1, Rounds do
+		SampleArray:Clear()
+		for j=1, NumSamples do
+			SampleArray:Add(Samples[j])
+		end
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "TArray<float>:Add(number) with 100k items ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	local SampleView = SampleArray:View()
+
+	StartTime = Seconds()
+	for i=1, Rounds do
+		for j=1, NumSamples do
+			local Sample = SampleArray[j]
+		end
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "read TArray<float>[i] with 100k items ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	StartTime = Seconds()
+	for i=1, Rounds do
+		for j=1, NumSamples do
+			local Sample = SampleView[j]
+		end
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "read TArray<float>:View()[i] with 100k items ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	StartTime = Seconds()
+	for i=1, Rounds do
+		for j=1, NumSamples do
+			SampleView[j] = j
+		end
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "write TArray<float>:View()[i] with 100k items ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	StartTime = Seconds()
+	for i=1, Rounds do
+		for j=1, NumSamples do
+			local Sample = Samples[j]
+		end
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "read Lua table[i] with 100k items ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	local function EmptyCoroutine()
+	end
+
+	StartTime = Seconds()
+	for i=1, N do
+		coroutine.resume(coroutine.create(EmptyCoroutine))
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "coroutine.resume(coroutine.create(Function)) ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	StartTime = Seconds()
+	for i=1, N do
+		UnLua_StartCoroutine(EmptyCoroutine)
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "UnLua_StartCoroutine(Function) ; "..tostring((EndTime - StartTime) * Multiplier)
+
+	-- spawn throughput, the class level binding is done by the first bound spawn only
+	local NumSpawns = 1000
+	local SpawnMultiplier = 1000000000.0 / NumSpawns
+	package.loaded.UnLuaPerformanceTestSpawnee = { Initialize = function(Spawnee) Spawnee.Health = 100 end }
+	local World = self:GetWorld()
+	local SpawnTransform = self:GetTransform()
+	local AlwaysSpawn = UE4.ESpawnActorCollisionHandlingMethod.AlwaysSpawn
+	local SpawnedActors = {}
+
+	StartTime = Seconds()
+	for i=1, NumSpawns do
+		SpawnedActors[i] = World:SpawnActor(UE4.ATargetPoint, SpawnTransform, AlwaysSpawn, self, self)
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "SpawnActor() ; "..tostring((EndTime - StartTime) * SpawnMultiplier)
+	for i=1, NumSpawns do
+		SpawnedActors[i]:K2_DestroyActor()
+	end
+
+	StartTime = Seconds()
+	for i=1, NumSpawns do
+		SpawnedActors[i] = World:SpawnActor(UE4.ATargetPoint, SpawnTransform, AlwaysSpawn, self, self, "UnLuaPerformanceTestSpawnee")
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "SpawnActor() with dynamic binding ; "..tostring((EndTime - StartTime) * SpawnMultiplier)
+	Message = Message .. "\n" .. "bound actors per second ; "..tostring(NumSpawns / (EndTime - StartTime))
+	for i=1, NumSpawns do
+		SpawnedActors[i]:K2_DestroyActor()
+	end
+
+	-- bind/unbind cost of Lua callbacks, every callback is a new closure
+	local NumBindings = 1000
+	local BindMultiplier = 1000000000.0 / NumBindings
+	local Callbacks = {}
+	for i=1, NumBindings do
+		Callbacks[i] = function() end
+	end
+
+	StartTime = Seconds()
+	for i=1, NumBindings do
+		self.OnActorBeginOverlap:Add(self, Callbacks[i])
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "MulticastDelegate:Add() ; "..tostring((EndTime - StartTime) * BindMultiplier)
+
+	StartTime = Seconds()
+	for i=1, NumBindings do
+		self.OnActorBeginOverlap:Remove(self, Callbacks[i])
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "MulticastDelegate:Remove() ; "..tostring((EndTime - StartTime) * BindMultiplier)
+
+	StartTime = Seconds()
+	for i=1, NumBindings do
+		self.OnActorBeginOverlap:Add(self, Callbacks[i])
+		self.OnActorBeginOverlap:Remove(self, Callbacks[i])
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "MulticastDelegate:Add() + Remove() ; "..tostring((EndTime - StartTime) * BindMultiplier)
+
+	-- all listeners are Lua callbacks, parameters are forwarded Lua to Lua
+	local NumOverlaps = 0
+	local OnOverlap1 = function(Self, OverlappedActor, OtherActor) NumOverlaps = NumOverlaps + 1 end
+	local OnOverlap2 = function(Self, OverlappedActor, OtherActor) NumOverlaps = NumOverlaps + 1 end
+	self.OnActorBeginOverlap:Add(self, OnOverlap1)
+	self.OnActorBeginOverlap:Add(self, OnOverlap2)
+	StartTime = Seconds()
+	for i=1, N do
+		self.OnActorBeginOverlap:Broadcast(self, self)
+	end
+	EndTime = Seconds()
+	Message = Message .. "\n" .. "MulticastDelegate:Broadcast() to 2 Lua callbacks ; "..tostring((EndTime - StartTime) * Multiplier)
+	self.OnActorBeginOverlap:Remove(self, OnOverlap1)
+	self.OnActorBeginOverlap:Remove(self, OnOverlap2)
+
 	StartTime = Seconds()
 	for i=1, N do
 		local HitResult = UE4.FHitResult()
@@ -200,6 +500,8 @@ function UnLuaPerformanceTestProxy:ReceiveBeginPlay()
 	EndTime = Seconds()
 	Message = Message .. "\n" .. "FHitResult() ; "..tostring((EndTime - StartTime) * Multiplier)
 
+	Message = Message .. "\n" .. BenchmarkLuaAllocators(N)
+
 	LogPerformanceData(Message)
 end
 
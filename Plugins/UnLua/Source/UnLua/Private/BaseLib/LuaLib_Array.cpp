@@ -16,6 +16,208 @@
 #include "LuaCore.h"
 #include "Containers/LuaArray.h"
 
+/**
+ * POD element types which are transferred between TArray and Lua table in bulk
+ */
+enum class EArrayBulkType : uint8
+{
+    None,
+    Int32,
+    Int64,
+    Float,
+    Double,
+    Bool,
+    Vector,
+};
+
+static EArrayBulkType GetArrayBulkType(const FLuaArray *Array)
+{
+    const FProperty *Property = Array->Inner->GetUProperty();
+    if (!Property || Property->ArrayDim != 1)
+    {
+        return EArrayBulkType::None;
+    }
+
+    if (Property->IsA<FIntProperty>())
+    {
+        return EArrayBulkType::Int32;
+    }
+    if (Property->IsA<FInt64Property>())
+    {
+        return EArrayBulkType::Int64;
+    }
+    if (Property->IsA<FFloatProperty>())
+    {
+        return EArrayBulkType::Float;
+    }
+    if (Property->IsA<FDoubleProperty>())
+    {
+        return EArrayBulkType::Double;
+    }
+    const FBoolProperty *BoolProperty = CastField<FBoolProperty>(Property);
+    if (BoolProperty && BoolProperty->IsNativeBool())
+    {
+        return EArrayBulkType::Bool;
+    }
+    const FStructProperty *StructProperty = CastField<FStructProperty>(Property);
+    if (StructProperty && StructProperty->Struct == TBaseStructure<FVector>::Get())
+    {
+        return EArrayBulkType::Vector;
+    }
+    return EArrayBulkType::None;
+}
+
+template <typename T>
+static void PushIntegers(lua_State *L, const T *Data, int32 Num)
+{
+    for (int32 i = 0; i < Num; ++i)
+    {
+        lua_pushinteger(L, (lua_Integer)Data[i]);
+        lua_rawseti(L, -2, i + 1);
+    }
+}
+
+template <typename T>
+static void PushNumbers(lua_State *L, const T *Data, int32 Num)
+{
+    for (int32 i = 0; i < Num; ++i)
+    {
+        lua_pushnumber(L, (lua_Number)Data[i]);
+        lua_rawseti(L, -2, i + 1);
+    }
+}
+
+template <typename T>
+static void ReadIntegers(lua_State *L, int32 TableIndex, T *Data, int32 Num)
+{
+    for (int32 i = 0; i < Num; ++i)
+    {
+        lua_rawgeti(L, TableIndex, i + 1);
+        Data[i] = (T)lua_tointeger(L, -1);
+        lua_pop(L, 1);
+    }
+}
+
+template <typename T>
+static void ReadNumbers(lua_State *L, int32 TableIndex, T *Data, int32 Num)
+{
+    for (int32 i = 0; i < Num; ++i)
+    {
+        lua_rawgeti(L, TableIndex, i + 1);
+        Data[i] = (T)lua_tonumber(L, -1);
+        lua_pop(L, 1);
+    }
+}
+
+/**
+ * Push a presized Lua table with all elements of the array. POD numeric/boolean elements are
+ * read straight from the FScriptArray memory, others go through the inner type interface.
+ */
+static void PushArrayAsTable(lua_State *L, FLuaArray *Array)
+{
+    const int32 Num = Array->Num();
+    lua_createtable(L, Num, 0);
+    if (Num < 1)
+    {
+        return;
+    }
+
+    const uint8 *Data = Array->GetData(0);
+    switch (GetArrayBulkType(Array))
+    {
+    case EArrayBulkType::Int32:
+        PushIntegers(L, (const int32*)Data, Num);
+        break;
+    case EArrayBulkType::Int64:
+        PushIntegers(L, (const int64*)Data, Num);
+        break;
+    case EArrayBulkType::Float:
+        PushNumbers(L, (const float*)Data, Num);
+        break;
+    case EArrayBulkType::Double:
+        PushNumbers(L, (const double*)Data, Num);
+        break;
+    case EArrayBulkType::Bool:
+        for (int32 i = 0; i < Num; ++i)
+        {
+            lua_pushboolean(L, ((const bool*)Data)[i]);
+            lua_rawseti(L, -2, i + 1);
+        }
+        break;
+    default:
+        for (int32 i = 0; i < Num; ++i)
+        {
+            Array->Inner->Read(L, Array->GetData(i), true);
+            lua_rawseti(L, -2, i + 1);
+        }
+        break;
+    }
+}
+
+/**
+ * Append all elements of a Lua sequence to the array. The FScriptArray grows once, POD elements
+ * are written straight into its memory, others go through the inner type interface.
+ */
+static void AppendTableToArray(lua_State *L, FLuaArray *Array, int32 TableIndex)
+{
+    TableIndex = lua_absindex(L, TableIndex);
+    const int32 Num = (int32)lua_rawlen(L, TableIndex);
+    if (Num < 1)
+    {
+        return;
+    }
+
+    const EArrayBulkType BulkType = GetArrayBulkType(Array);
+    if (BulkType == EArrayBulkType::None)
+    {
+        const int32 Index = Array->AddDefaulted(Num);
+        for (int32 i = 0; i < Num; ++i)
+        {
+            lua_rawgeti(L, TableIndex, i + 1);
+            Array->Inner->Write(L, Array->GetData(Index + i), lua_gettop(L));
+            lua_pop(L, 1);
+        }
+        return;
+    }
+
+    uint8 *Data = Array->GetData(Array->AddUninitialized(Num));
+    switch (BulkType)
+    {
+    case EArrayBulkType::Int32:
+        ReadIntegers(L, TableIndex, (int32*)Data, Num);
+        break;
+    case EArrayBulkType::Int64:
+        ReadIntegers(L, TableIndex, (int64*)Data, Num);
+        break;
+    case EArrayBulkType::Float:
+        ReadNumbers(L, TableIndex, (float*)Data, Num);
+        break;
+    case EArrayBulkType::Double:
+        ReadNumbers(L, TableIndex, (double*)Data, Num);
+        break;
+    case EArrayBulkType::Bool:
+        for (int32 i = 0; i < Num; ++i)
+        {
+            lua_rawgeti(L, TableIndex, i + 1);
+            ((bool*)Data)[i] = !!lua_toboolean(L, -1);
+            lua_pop(L, 1);
+        }
+        break;
+    case EArrayBulkType::Vector:
+        for (int32 i = 0; i < Num; ++i)
+        {
+            lua_rawgeti(L, TableIndex, i + 1);
+            const FVector *Vector = (const FVector*)GetCppInstanceFast(L, -1);
+            ((FVector*)Data)[i] = Vector ? *Vector : FVector::ZeroVector;
+            lua_pop(L, 1);
+        }
+        break;
+    default:
+        check(false);
+        break;
+    }
+}
+
 static int32 TArray_New(lua_State *L)
 {
     int32 NumParams = lua_gettop(L);
@@ -351,10 +553,7 @@ static int32 TArray_Get(lua_State *L)
         return 0;
     }
 
-    Array->Inner->Initialize(Array->ElementCache);
-    Array->Get(Index, Array->ElementCache);
-    Array->Inner->Read(L, Array->ElementCache, true);
-    Array->Inner->Destruct(Array->ElementCache);
+    Array->Inner->Read(L, Array->GetData(Index), true);      // copy straight from the element, 'ElementCache' is not needed
     return 1;
 }
 
@@ -554,7 +753,7 @@ static int32 TArray_Contains(lua_State *L)
 }
 
 /**
- * @see FLuaArray::Append(...)
+ * @see FLuaArray::Append(...). Also accepts a Lua sequence
  */
 static int32 TArray_Append(lua_State *L)
 {
@@ -572,6 +771,12 @@ static int32 TArray_Append(lua_State *L)
         return 0;
     }
 
+    if (lua_type(L, 2) == LUA_TTABLE)
+    {
+        AppendTableToArray(L, Array, 2);
+        return 0;
+    }
+
     FLuaArray *SourceArray = (FLuaArray*)(GetCppInstanceFast(L, 2));
     if (!SourceArray)
     {
@@ -625,19 +830,330 @@ static int32 TArray_ToTable(lua_State *L)
         return 0;
     }
 
-    lua_newtable(L);
-    Array->Inner->Initialize(Array->ElementCache);
-    for (int32 i = 0; i < Array->Num(); ++i)
+    PushArrayAsTable(L, Array);
+    return 1;
+}
+
+/**
+ * Replace the content of the array with the elements of a Lua sequence
+ */
+static int32 TArray_FromTable(lua_State *L)
+{
+    int32 NumParams = lua_gettop(L);
+    if (NumParams != 2 || lua_type(L, 2) != LUA_TTABLE)
     {
-        lua_pushinteger(L, i + 1);
-        Array->Get(i, Array->ElementCache);
-        Array->Inner->Read(L, Array->ElementCache, true);
-        lua_rawset(L, -3);
+        UNLUA_LOGERROR(L, LogUnLua, Log, TEXT("%s: Invalid parameters!"), ANSI_TO_TCHAR(__FUNCTION__));
+        return 0;
     }
-    Array->Inner->Destruct(Array->ElementCache);
+
+    FLuaArray *Array = (FLuaArray*)(GetCppInstanceFast(L, 1));
+    if (!Array)
+    {
+        UNLUA_LOGERROR(L, LogUnLua, Log, TEXT("%s: Invalid TArray!"), ANSI_TO_TCHAR(__FUNCTION__));
+        return 0;
+    }
+
+    Array->Clear();
+    AppendTableToArray(L, Array, 2);
+    return 0;
+}
+
+/**
+ * '__len' meta method, equivalent to 'Length'
+ */
+static int32 TArray_Len(lua_State *L)
+{
+    FLuaArray *Array = (FLuaArray*)(GetCppInstanceFast(L, 1));
+    lua_pushinteger(L, Array ? Array->Num() : 0);
     return 1;
 }
 
+/**
+ * '__index' meta method. Integer keys read the element in place (1-based, nil if out of range),
+ * other keys are looked up in the metatable
+ */
+static int32 TArray_Index(lua_State *L)
+{
+    int32 bIsInteger = 0;
+    lua_Integer Index = lua_type(L, 2) == LUA_TNUMBER ? lua_tointegerx(L, 2, &bIsInteger) : 0;
+    if (bIsInteger)
+    {
+        FLuaArray *Array = (FLuaArray*)(GetCppInstanceFast(L, 1));
+        if (Array && Index > 0 && Index <= Array->Num())
+        {
+            Array->Inner->Read(L, Array->GetData((int32)Index - 1), true);
+            return 1;
+        }
+        lua_pushnil(L);
+        return 1;
+    }
+
+    if (!lua_getmetatable(L, 1))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+    lua_pushvalue(L, 2);
+    lua_rawget(L, -2);
+    return 1;
+}
+
+/**
+ * '__newindex' meta method. Integer keys write the element in place, 'Length + 1' appends a new element,
+ * other keys raise an error
+ */
+static int32 TArray_NewIndex(lua_State *L)
+{
+    int32 bIsInteger = 0;
+    lua_Integer Index = lua_type(L, 2) == LUA_TNUMBER ? lua_tointegerx(L, 2, &bIsInteger) : 0;
+    if (bIsInteger)
+    {
+        FLuaArray *Array = (FLuaArray*)(GetCppInstanceFast(L, 1));
+        if (!Array)
+        {
+            UNLUA_LOGERROR(L, LogUnLua, Log, TEXT("%s: Invalid TArray!"), ANSI_TO_TCHAR(__FUNCTION__));
+            return 0;
+        }
+
+        const int32 Num = Array->Num();
+        if (Index == Num + 1)
+        {
+            Array->AddDefaulted();
+        }
+        else if (Index < 1 || Index > Num)
+        {
+            UNLUA_LOGERROR(L, LogUnLua, Log, TEXT("%s: TArray Invalid Index!"), ANSI_TO_TCHAR(__FUNCTION__));
+            return 0;
+        }
+
+        Array->Inner->Write(L, Array->GetData((int32)Index - 1), 3);
+        return 0;
+    }
+
+    return luaL_error(L, "TArray only supports integer keys, the metatable is shared by all arrays");
+}
+
+/**
+ * Stateless iterator used by '__pairs', yields (Index, Element) with 1-based indices
+ */
+static int32 TArray_Next(lua_State *L)
+{
+    FLuaArray *Array = (FLuaArray*)(GetCppInstanceFast(L, 1));
+    const int32 Index = (int32)lua_tointeger(L, 2);
+    if (!Array || Index < 0 || Index >= Array->Num())
+    {
+        return 0;
+    }
+
+    lua_pushinteger(L, Index + 1);
+    Array->Inner->Read(L, Array->GetData(Index), true);
+    return 2;
+}
+
+/**
+ * '__pairs' meta method, iterates the underlying FScriptArray in place
+ */
+static int32 TArray_Pairs(lua_State *L)
+{
+    lua_pushcfunction(L, TArray_Next);
+    lua_pushvalue(L, 1);
+    lua_pushinteger(L, 0);
+    return 3;
+}
+
+/**
+ * A typed view aliasing the memory of a FScriptArray with numeric/boolean elements. Data and length are
+ * fetched from the FScriptArray on every access, so the view stays valid when the array reallocates.
+ */
+struct FLuaArrayView
+{
+    FScriptArray *ScriptArray;
+    int32 ElementSize;
+    int32 SourceRef;            // reference to the source TArray userdata, keeps it alive
+    EArrayBulkType Type;
+};
+
+/**
+ * Create a view for a numeric/boolean array, see FLuaArrayView
+ */
+static int32 TArray_View(lua_State *L)
+{
+    int32 NumParams = lua_gettop(L);
+    if (NumParams != 1)
+    {
+        UNLUA_LOGERROR(L, LogUnLua, Log, TEXT("%s: Invalid parameters!"), ANSI_TO_TCHAR(__FUNCTION__));
+        return 0;
+    }
+
+    FLuaArray *Array = (FLuaArray*)(GetCppInstanceFast(L, 1));
+    if (!Array)
+    {
+        UNLUA_LOGERROR(L, LogUnLua, Log, TEXT("%s: Invalid TArray!"), ANSI_TO_TCHAR(__FUNCTION__));
+        return 0;
+    }
+
+    const EArrayBulkType Type = GetArrayBulkType(Array);
+    if (Type == EArrayBulkType::None || Type == EArrayBulkType::Vector)
+    {
+        UNLUA_LOGERROR(L, LogUnLua, Log, TEXT("%s: Only TArray with numeric or boolean elements can be viewed!"), ANSI_TO_TCHAR(__FUNCTION__));
+        return 0;
+    }
+
+    FLuaArrayView *View = (FLuaArrayView*)NewUserdataWithPadding(L, sizeof(FLuaArrayView), "TArrayView");
+    if (!View)
+    {
+        return 0;
+    }
+    View->ScriptArray = Array->ScriptArray;
+    View->ElementSize = Array->ElementSize;
+    View->Type = Type;
+    lua_pushvalue(L, 1);
+    View->SourceRef = luaL_ref(L, LUA_REGISTRYINDEX);
+    return 1;
+}
+
+static FORCEINLINE void PushViewElement(lua_State *L, const FLuaArrayView *View, const uint8 *Element)
+{
+    switch (View->Type)
+    {
+    case EArrayBulkType::Int32:
+        lua_pushinteger(L, *(const int32*)Element);
+        break;
+    case EArrayBulkType::Int64:
+        lua_pushinteger(L, *(const int64*)Element);
+        break;
+    case EArrayBulkType::Float:
+        lua_pushnumber(L, *(const float*)Element);
+        break;
+    case EArrayBulkType::Double:
+        lua_pushnumber(L, *(const double*)Element);
+        break;
+    case EArrayBulkType::Bool:
+        lua_pushboolean(L, *(const bool*)Element);
+        break;
+    default:
+        lua_pushnil(L);
+        break;
+    }
+}
+
+/**
+ * '__index' meta method of the view. Integer keys read the element in place (1-based, nil if out of range),
+ * other keys are looked up in the metatable
+ */
+static int32 TArrayView_Index(lua_State *L)
+{
+    int32 bIsInteger = 0;
+    lua_Integer Index = lua_type(L, 2) == LUA_TNUMBER ? lua_tointegerx(L, 2, &bIsInteger) : 0;
+    if (bIsInteger)
+    {
+        const FLuaArrayView *View = (const FLuaArrayView*)(GetCppInstanceFast(L, 1));
+        if (View && Index > 0 && Index <= View->ScriptArray->Num())
+        {
+            PushViewElement(L, View, (const uint8*)View->ScriptArray->GetData() + (Index - 1) * View->ElementSize);
+            return 1;
+        }
+        lua_pushnil(L);
+        return 1;
+    }
+
+    if (!lua_getmetatable(L, 1))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+    lua_pushvalue(L, 2);
+    lua_rawget(L, -2);
+    return 1;
+}
+
+/**
+ * '__newindex' meta method of the view, writes the element in place. The view can't change the length of the array.
+ */
+static int32 TArrayView_NewIndex(lua_State *L)
+{
+    const FLuaArrayView *View = (const FLuaArrayView*)(GetCppInstanceFast(L, 1));
+    int32 bIsInteger = 0;
+    lua_Integer Index = lua_type(L, 2) == LUA_TNUMBER ? lua_tointegerx(L, 2, &bIsInteger) : 0;
+    if (!View || !bIsInteger || Index < 1 || Index > View->ScriptArray->Num())
+    {
+        UNLUA_LOGERROR(L, LogUnLua, Log, TEXT("%s: TArrayView Invalid Index!"), ANSI_TO_TCHAR(__FUNCTION__));
+        return 0;
+    }
+
+    uint8 *Element = (uint8*)View->ScriptArray->GetData() + (Index - 1) * View->ElementSize;
+    switch (View->Type)
+    {
+    case EArrayBulkType::Int32:
+        *(int32*)Element = (int32)lua_tointeger(L, 3);
+        break;
+    case EArrayBulkType::Int64:
+        *(int64*)Element = (int64)lua_tointeger(L, 3);
+        break;
+    case EArrayBulkType::Float:
+        *(float*)Element = (float)lua_tonumber(L, 3);
+        break;
+    case EArrayBulkType::Double:
+        *(double*)Element = (double)lua_tonumber(L, 3);
+        break;
+    case EArrayBulkType::Bool:
+        *(bool*)Element = !!lua_toboolean(L, 3);
+        break;
+    default:
+        break;
+    }
+    return 0;
+}
+
+/**
+ * '__len' meta method of the view
+ */
+static int32 TArrayView_Len(lua_State *L)
+{
+    const FLuaArrayView *View = (const FLuaArrayView*)(GetCppInstanceFast(L, 1));
+    lua_pushinteger(L, View ? View->ScriptArray->Num() : 0);
+    return 1;
+}
+
+/**
+ * Stateless iterator used by '__pairs' of the view, yields (Index, Element) with 1-based indices
+ */
+static int32 TArrayView_Next(lua_State *L)
+{
+    const FLuaArrayView *View = (const FLuaArrayView*)(GetCppInstanceFast(L, 1));
+    const int32 Index = (int32)lua_tointeger(L, 2);
+    if (!View || Index < 0 || Index >= View->ScriptArray->Num())
+    {
+        return 0;
+    }
+
+    lua_pushinteger(L, Index + 1);
+    PushViewElement(L, View, (const uint8*)View->ScriptArray->GetData() + Index * View->ElementSize);
+    return 2;
+}
+
+static int32 TArrayView_Pairs(lua_State *L)
+{
+    lua_pushcfunction(L, TArrayView_Next);
+    lua_pushvalue(L, 1);
+    lua_pushinteger(L, 0);
+    return 3;
+}
+
+/**
+ * GC function of the view, releases the source TArray
+ */
+static int32 TArrayView_Delete(lua_State *L)
+{
+    FLuaArrayView *View = (FLuaArrayView*)(GetCppInstanceFast(L, 1));
+    if (View)
+    {
+        luaL_unref(L, LUA_REGISTRYINDEX, View->SourceRef);
+        View->SourceRef = LUA_NOREF;
+    }
+    return 0;
+}
+
 static const luaL_Reg TArrayLib[] =
 {
     { "Length", TArray_Length },
@@ -661,6 +1177,12 @@ static const luaL_Reg TArrayLib[] =
     { "Contains", TArray_Contains },
     { "Append", TArray_Append },
     { "ToTable", TArray_ToTable },
+    { "FromTable", TArray_FromTable },
+    { "View", TArray_View },
+    { "__len", TArray_Len },
+    { "__index", TArray_Index },
+    { "__newindex", TArray_NewIndex },
+    { "__pairs", TArray_Pairs },
     { "__gc", TArray_Delete },
     { "__call", TArray_New },
     { nullptr, nullptr }
@@ -668,3 +1190,16 @@ static const luaL_Reg TArrayLib[] =
 
 EXPORT_UNTYPED_CLASS(TArray, false, TArrayLib)
 IMPLEMENT_EXPORTED_CLASS(TArray)
+
+static const luaL_Reg TArrayViewLib[] =
+{
+    { "__index", TArrayView_Index },
+    { "__newindex", TArrayView_NewIndex },
+    { "__len", TArrayView_Len },
+    { "__pairs", TArrayView_Pairs },
+    { "__gc", TArrayView_Delete },
+    { nullptr, nullptr }
+};
+
+EXPORT_UNTYPED_CLASS(TArrayView, false, TArrayViewLib)
+IMPLEMENT_EXPORTED_CLASS(TArrayView)
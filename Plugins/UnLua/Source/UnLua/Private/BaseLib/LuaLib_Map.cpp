@@ -339,6 +339,58 @@ static int32 TMap_ToTable(lua_State *L)
     return 1;
 }
 
+/**
+ * '__len' meta method, equivalent to 'Length'
+ */
+static int32 TMap_Len(lua_State *L)
+{
+    FLuaMap *Map = (FLuaMap*)(GetCppInstanceFast(L, 1));
+    lua_pushinteger(L, Map ? Map->Num() : 0);
+    return 1;
+}
+
+/**
+ * Iterator closure used by '__pairs', yields (Key, Value) read in place from the pairs of the FScriptMap.
+ * The current sparse index is kept in the first upvalue.
+ */
+static int32 TMap_Next(lua_State *L)
+{
+    FLuaMap *Map = (FLuaMap*)(GetCppInstanceFast(L, 1));
+    if (!Map)
+    {
+        return 0;
+    }
+
+    const int32 Index = Map->GetNextValidIndex((int32)lua_tointeger(L, lua_upvalueindex(1)));
+    if (Index == INDEX_NONE)
+    {
+        return 0;
+    }
+    lua_pushinteger(L, Index);
+    lua_replace(L, lua_upvalueindex(1));
+
+    uint8 *Pair = Map->GetData(Index);
+    int32 KeyOffset = 0;
+#if ENGINE_MAJOR_VERSION <= 4 && ENGINE_MINOR_VERSION < 22
+    KeyOffset = Map->MapLayout.KeyOffset;
+#endif
+    Map->KeyInterface->Read(L, Pair + KeyOffset, true);
+    Map->ValueInterface->Read(L, Map->ValueInterface->GetOffset() > 0 ? Pair : Pair + Map->MapLayout.ValueOffset, true);
+    return 2;
+}
+
+/**
+ * '__pairs' meta method, iterates the underlying FScriptMap in place
+ */
+static int32 TMap_Pairs(lua_State *L)
+{
+    lua_pushinteger(L, INDEX_NONE);
+    lua_pushcclosure(L, TMap_Next, 1);
+    lua_pushvalue(L, 1);
+    lua_pushnil(L);
+    return 3;
+}
+
 static const luaL_Reg TMapLib[] =
 {
     { "Length", TMap_Length },
@@ -350,6 +402,8 @@ static const luaL_Reg TMapLib[] =
     { "Keys", TMap_Keys },
     { "Values", TMap_Values },
     { "ToTable", TMap_ToTable },
+    { "__len", TMap_Len },
+    { "__pairs", TMap_Pairs },
     { "__gc", TMap_Delete },
     { "__call", TMap_New },
     { nullptr, nullptr }
@@ -331,8 +331,14 @@ int32 UObject_Delete(lua_State *L)
         Object = bTwoLvlPtr ? (UObject*)(*((void**)Userdata)) : (UObject*)Userdata;
         if (Object)
         {
-            GReflectionRegistry.AddToGCSet(Object);
-            DeleteUObjectRefs(L,Object);
+            // the reference of the userdata is released in a batch after lua gc
+            GObjectReferencer.NotifyUserdataCollected(Object, HasUserdataObjectRef(L, 1));
+
+            // delegate ref, delegate must be clear before object is gced
+            if (GLuaCxt->IsUObjectValid(Object) && GLuaCxt->IsEnable())
+            {
+                FDelegateHelper::Remove(Object);
+            }
         }
     }
        
@@ -246,6 +246,53 @@ static int32 TSet_ToTable(lua_State *L)
     return 1;
 }
 
+/**
+ * '__len' meta method, equivalent to 'Length'
+ */
+static int32 TSet_Len(lua_State *L)
+{
+    FLuaSet *Set = (FLuaSet*)(GetCppInstanceFast(L, 1));
+    lua_pushinteger(L, Set ? Set->Num() : 0);
+    return 1;
+}
+
+/**
+ * Iterator closure used by '__pairs', yields (Element, true) read in place from the FScriptSet,
+ * so the loop reads like iterating a Lua table used as a set. The current sparse index is kept in the first upvalue.
+ */
+static int32 TSet_Next(lua_State *L)
+{
+    FLuaSet *Set = (FLuaSet*)(GetCppInstanceFast(L, 1));
+    if (!Set)
+    {
+        return 0;
+    }
+
+    const int32 Index = Set->GetNextValidIndex((int32)lua_tointeger(L, lua_upvalueindex(1)));
+    if (Index == INDEX_NONE)
+    {
+        return 0;
+    }
+    lua_pushinteger(L, Index);
+    lua_replace(L, lua_upvalueindex(1));
+
+    Set->ElementInterface->Read(L, Set->GetData(Index), true);
+    lua_pushboolean(L, true);
+    return 2;
+}
+
+/**
+ * '__pairs' meta method, iterates the underlying FScriptSet in place
+ */
+static int32 TSet_Pairs(lua_State *L)
+{
+    lua_pushinteger(L, INDEX_NONE);
+    lua_pushcclosure(L, TSet_Next, 1);
+    lua_pushvalue(L, 1);
+    lua_pushnil(L);
+    return 3;
+}
+
 static const luaL_Reg TSetLib[] =
 {
     { "Length", TSet_Length },
@@ -255,6 +302,8 @@ static const luaL_Reg TSetLib[] =
     { "Clear", TSet_Clear },
     { "ToArray", TSet_ToArray },
     { "ToTable", TSet_ToTable },
+    { "__len", TSet_Len },
+    { "__pairs", TSet_Pairs },
     { "__gc", TSet_Delete },
     { "__call", TSet_New },
     { nullptr, nullptr }
@@ -238,6 +238,25 @@ public:
         return (uint8*)Map->GetData(Index, MapLayout);
     }
 
+    /**
+     * Get the next valid sparse index after the given one, used to walk the map in place
+     *
+     * @param Index - the index to start after, pass INDEX_NONE to get the first valid index
+     * @return - the next valid index, or INDEX_NONE if there are no more pairs
+     */
+    FORCEINLINE int32 GetNextValidIndex(int32 Index) const
+    {
+        const int32 MaxIndex = Map->GetMaxIndex();
+        while (++Index < MaxIndex)
+        {
+            if (IsValidIndex(Index))
+            {
+                return Index;
+            }
+        }
+        return INDEX_NONE;
+    }
+
     /**
      * Adds an uninitialized pair to the map. The map needs rehashing to make it valid.
      *
@@ -180,6 +180,25 @@ public:
         return (uint8*)Set->GetData(Index, SetLayout);
     }
 
+    /**
+     * Get the next valid sparse index after the given one, used to walk the set in place
+     *
+     * @param Index - the index to start after, pass INDEX_NONE to get the first valid index
+     * @return - the next valid index, or INDEX_NONE if there are no more elements
+     */
+    FORCEINLINE int32 GetNextValidIndex(int32 Index) const
+    {
+        const int32 MaxIndex = Set->GetMaxIndex();
+        while (++Index < MaxIndex)
+        {
+            if (IsValidIndex(Index))
+            {
+                return Index;
+            }
+        }
+        return INDEX_NONE;
+    }
+
     /**
      * Adds an uninitialized element to the set. The set needs rehashing to make it valid.
      *
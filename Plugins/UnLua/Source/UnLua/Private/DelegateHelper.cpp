@@ -16,6 +16,7 @@
 #include "LuaFunctionInjection.h"
 #include "ReflectionUtils/ReflectionRegistry.h"
 #include "ReflectionUtils/PropertyDesc.h"
+#include "LuaCore.h"
 #include "lua.hpp"
 
 void FSignatureDesc::MarkForDelete(bool bIgnoreBindings, UObject* Object)
@@ -34,7 +35,7 @@ void FSignatureDesc::MarkForDelete(bool bIgnoreBindings, UObject* Object)
 	}
 
 	UE_LOG(UnLuaDelegate, Verbose, TEXT("Clean %d %s %p %s"), NumBindings, Object ? *Object->GetName() : TEXT("nullptr"), Object, *SignatureFunctionDesc->GetFunction()->GetName());
-	FDelegateHelper::CleanUpByFunction(SignatureFunctionDesc->GetFunction());
+	FDelegateHelper::CleanUpBySignature(this);
 }
 
 void FSignatureDesc::Execute(UObject *Context, FFrame &Stack, void *RetValueAddress)
@@ -42,19 +43,37 @@ void FSignatureDesc::Execute(UObject *Context, FFrame &Stack, void *RetValueAddr
     if (SignatureFunctionDesc)
     {
         ++NumCalls;         // inc calls, so it won't be deleted during call
-        SignatureFunctionDesc->CallLua(Context, Stack, RetValueAddress, false, false);
-        --NumCalls;         // dec calls
-        if (!NumCalls && bPendingKill)
+        SignatureFunctionDesc->CallLua(Context, CallbackRef, Stack, RetValueAddress);
+        EndCall();
+    }
+}
+
+void FSignatureDesc::Execute(lua_State *L, int32 NumParams, int32 FirstParamIndex)
+{
+    // the caller holds a call, the parameters are forwarded from the Lua stack
+    if (PushFunction(L, Callback.Object, CallbackRef))
+    {
+        for (int32 i = 0; i < NumParams; ++i)
         {
-            if (NumBindings > 1) // NumBindings may increase when running CallLua
-            {
-                bPendingKill = false;
-				UE_LOG(UnLuaDelegate, Verbose, TEXT("++ again after --, cannot kill dele, %d %s %p %s"), NumBindings, Context ? *Context->GetName() : TEXT("nullptr"), Context, *SignatureFunctionDesc->GetFunction()->GetName());
-            }
-            else
-            {
-                FDelegateHelper::CleanUpByFunction(SignatureFunctionDesc->GetFunction());       // clean up the delegate only if there is only one bindings.
-            }
+            lua_pushvalue(L, FirstParamIndex + i);
+        }
+        CallFunction(L, NumParams + 1, 0);
+    }
+}
+
+void FSignatureDesc::EndCall()
+{
+    --NumCalls;         // dec calls
+    if (!NumCalls && bPendingKill)
+    {
+        if (NumBindings > 1) // NumBindings may increase when running CallLua
+        {
+            bPendingKill = false;
+            UE_LOG(UnLuaDelegate, Verbose, TEXT("++ again after --, cannot kill dele, %d %p %s"), NumBindings, Callback.Object, *SignatureFunctionDesc->GetFunction()->GetName());
+        }
+        else
+        {
+            FDelegateHelper::CleanUpBySignature(this);      // clean up the delegate only if there is only one bindings.
         }
     }
 }
@@ -65,21 +84,27 @@ TMap<FMulticastDelegateType*, FMulticastDelegateProperty*> FDelegateHelper::Mult
 TMap<FScriptDelegate*, FFunctionDesc*> FDelegateHelper::Delegate2Signatures;
 TMap<FMulticastDelegateType*, FFunctionDesc*> FDelegateHelper::MulticastDelegate2Signatures;
 
-TMap<UFunction*, FSignatureDesc*> FDelegateHelper::Function2Signature;
+TMap<FDelegateHelper::FBindingKey, FSignatureDesc*> FDelegateHelper::Binding2Signature;
 TMap<FCallbackDesc, UFunction*> FDelegateHelper::Callback2Function;
-TMap<UFunction*, FCallbackDesc> FDelegateHelper::Function2Callback;
-TMap<UClass*, TArray<UFunction*>> FDelegateHelper::Class2Functions;
+TMap<UClass*, TArray<FSignatureDesc*>> FDelegateHelper::Class2Signatures;
+
+#if ENABLE_SHARED_DELEGATE_PROXY
+TMap<TPair<UClass*, UFunction*>, FDelegateHelper::FProxyFunctions> FDelegateHelper::ProxyFunctions;
+TMap<UObject*, TArray<UFunction*>> FDelegateHelper::RetiredProxies;
+int32 FDelegateHelper::NumProxyFunctions = 0;
+#endif
 
 TMap<FMulticastDelegateType*, TArray<FCallbackDesc>> FDelegateHelper::MutiDelegates2Callback;
 
 DEFINE_FUNCTION(FDelegateHelper::ProcessDelegate)
 {
-#if UE_BUILD_SHIPPING || UE_BUILD_TEST
+#if !ENABLE_SHARED_DELEGATE_PROXY && (UE_BUILD_SHIPPING || UE_BUILD_TEST)
     FSignatureDesc *SignatureDesc = nullptr;
     FMemory::Memcpy(&SignatureDesc, Stack.Code, sizeof(SignatureDesc));
     //Stack.SkipCode(sizeof(SignatureDesc));        // skip 'FSignatureDesc' pointer
 #else
-    FSignatureDesc **SignatureDescPtr = Function2Signature.Find(Stack.CurrentNativeFunction);   // find the signature
+    // a shared proxy UFunction is bound by many objects, the bound object tells the callback
+    FSignatureDesc **SignatureDescPtr = Binding2Signature.Find(FBindingKey(Context, Stack.CurrentNativeFunction));   // find the signature
     FSignatureDesc *SignatureDesc = SignatureDescPtr ? *SignatureDescPtr : nullptr;
 #endif
     if (SignatureDesc)
@@ -87,6 +112,12 @@ DEFINE_FUNCTION(FDelegateHelper::ProcessDelegate)
         SignatureDesc->Execute(Context, Stack, (void*)RESULT_PARAM);     // fire the delegate
         return;
     }
+#if ENABLE_SHARED_DELEGATE_PROXY
+    if (IsRetiredProxy(Context, Stack.CurrentNativeFunction))
+    {
+        return;         // a stale entry of a delegate, its callback has been unbound
+    }
+#endif
     UE_LOG(LogUnLua, Warning, TEXT("Failed to process delegate (%s)!"), *Stack.CurrentNativeFunction->GetName());
 }
 
@@ -95,7 +126,7 @@ FName FDelegateHelper::GetBindedFunctionName(const FCallbackDesc &Callback)
     UFunction **CallbackFuncPtr = Callback2Function.Find(Callback);
     if (CallbackFuncPtr && *CallbackFuncPtr)
     {
-        FSignatureDesc **SignatureDesc = Function2Signature.Find(*CallbackFuncPtr);
+        FSignatureDesc **SignatureDesc = Binding2Signature.Find(FBindingKey(Callback.Object, *CallbackFuncPtr));
         ++((*SignatureDesc)->NumBindings);          // inc bindings
         return (*CallbackFuncPtr)->GetFName();      // return function name
     }
@@ -107,7 +138,7 @@ int32 FDelegateHelper::GetNumBindings(const FCallbackDesc& Callback)
 	UFunction** CallbackFuncPtr = Callback2Function.Find(Callback);
 	if (CallbackFuncPtr && *CallbackFuncPtr)
 	{
-		FSignatureDesc** SignatureDesc = Function2Signature.Find(*CallbackFuncPtr);
+		FSignatureDesc** SignatureDesc = Binding2Signature.Find(FBindingKey(Callback.Object, *CallbackFuncPtr));
         return (*SignatureDesc)->NumBindings;
 	}
 	return -1;
@@ -132,6 +163,17 @@ bool FDelegateHelper::Bind(FScriptDelegate *ScriptDelegate, UObject *Object, con
 
 bool FDelegateHelper::Bind(FScriptDelegate *ScriptDelegate, FDelegateProperty *Property, UObject *Object, const FCallbackDesc &Callback, int32 CallbackRef)
 {
+#if ENABLE_SHARED_DELEGATE_PROXY
+    if (ScriptDelegate && ScriptDelegate->IsBound())
+    {
+        UObject *BoundObject = ScriptDelegate->GetUObject();
+        if (IsRetiredProxy(BoundObject, BoundObject->FindFunction(ScriptDelegate->GetFunctionName())))
+        {
+            ScriptDelegate->Unbind();       // the callback was unbound without the delegate, e.g. Unbind({Object, Callback})
+        }
+    }
+#endif
+
     if (!ScriptDelegate || ScriptDelegate->IsBound() || !Property || !Object || !Callback.Class || CallbackRef == INDEX_NONE)
     {
         UE_LOG(LogUnLua, Log, TEXT("%s: Invalid Delegate Bind! : %s"), ANSI_TO_TCHAR(__FUNCTION__), *(Property->GetName()));
@@ -141,20 +183,11 @@ bool FDelegateHelper::Bind(FScriptDelegate *ScriptDelegate, FDelegateProperty *P
 	UFunction** CallbackFuncPtr = Callback2Function.Find(Callback);
 	if (!CallbackFuncPtr)
 	{
-
-		lua_State* L = UnLua::GetState();
-		lua_Debug ar;
-
-		lua_getstack(L, 1, &ar);
-		lua_getinfo(L, "nSl", &ar);
-		int line = ar.linedefined;
-		auto name = ar.source;
-
-		FName FuncName(*FString::Printf(TEXT("LuaFunc:[%s:%d]_CppDelegate:[%s.%s_%s]"), ANSI_TO_TCHAR(name), line, *Object->GetName(), *Property->GetName(), *FGuid::NewGuid().ToString()));
+		FName FuncName = MakeSignatureName(TEXT("CppDelegate"), Object, Property);
+		FuncName = CreateSignature(Property->SignatureFunction, FuncName, Callback, CallbackRef)->GetFName();      // create the signature function for the callback
 
 		UE_LOG(UnLuaDelegate, Verbose, TEXT("++ 1 %s %p %s"), *Object->GetName(), Object, *FuncName.ToString());
         ScriptDelegate->BindUFunction(Object, FuncName);                                    // bind a callback to the delegate
-		CreateSignature(Property->SignatureFunction, FuncName, Callback, CallbackRef);      // create the signature function for the callback
 	}
 	return true;
 }
@@ -164,11 +197,8 @@ void FDelegateHelper::Unbind(const FCallbackDesc &Callback)
 	UFunction** FunctionPtr = Callback2Function.Find(Callback);
 	if (FunctionPtr && *FunctionPtr)
 	{
-        UFunction* Function = *FunctionPtr;
-        UObject* Object = Callback.Object;
-
 		// try to delete the signature
-		FSignatureDesc** SignatureDesc = Function2Signature.Find(Function);
+		FSignatureDesc** SignatureDesc = Binding2Signature.Find(FBindingKey(Callback.Object, *FunctionPtr));
 		if (SignatureDesc && *SignatureDesc)
 		{
 			(*SignatureDesc)->MarkForDelete();
@@ -191,7 +221,7 @@ void FDelegateHelper::Unbind(FScriptDelegate *ScriptDelegate)
         if (Function)
         {
             // try to delete the signature
-            FSignatureDesc **SignatureDesc = Function2Signature.Find(Function);
+            FSignatureDesc **SignatureDesc = Binding2Signature.Find(FBindingKey(Object, Function));
             if (SignatureDesc && *SignatureDesc)
             {
                 (*SignatureDesc)->MarkForDelete();
@@ -269,22 +299,14 @@ bool FDelegateHelper::Add(FMulticastDelegateType *ScriptDelegate, FMulticastDele
 	UFunction** CallbackFuncPtr = Callback2Function.Find(Callback);
 	if (!CallbackFuncPtr)
 	{
-		lua_State* L = UnLua::GetState();
-		lua_Debug ar;
-
-		lua_getstack(L, 1, &ar);
-		lua_getinfo(L, "nSl", &ar);
-		int line = ar.linedefined;
-		auto name = ar.source;
-
-		FName FuncName(*FString::Printf(TEXT("LuaFunc:[%s:%d]_CppMulticastDelegate:[%s.%s_%s]"), ANSI_TO_TCHAR(name), line, *Object->GetName(), *Property->GetName(), *FGuid::NewGuid().ToString()));
+		FName FuncName = MakeSignatureName(TEXT("CppMulticastDelegate"), Object, Property);
+		FuncName = CreateSignature(Property->SignatureFunction, FuncName, Callback, CallbackRef)->GetFName();      // create the signature function for the callback
 
         FScriptDelegate DynamicDelegate;
 		DynamicDelegate.BindUFunction(Object, FuncName);
 
 		UE_LOG(UnLuaDelegate, Verbose, TEXT("++ 1 %s %p %s"), *Object->GetName(), Object, *FuncName.ToString());
 
-		CreateSignature(Property->SignatureFunction, FuncName, Callback, CallbackRef);      // create the signature function for the callback
 		TMulticastDelegateTraits<FMulticastDelegateType>::AddDelegate(Property, DynamicDelegate, ScriptDelegate);   // add a callback to the delegate
 
 		TArray<FCallbackDesc>& DelegateCallbacks = MutiDelegates2Callback.FindOrAdd(ScriptDelegate);
@@ -326,7 +348,7 @@ void FDelegateHelper::Remove(FMulticastDelegateType *ScriptDelegate, UObject *Ob
             TMulticastDelegateTraits<FMulticastDelegateType>::RemoveDelegate(*Property, DynamicDelegate, ScriptDelegate);    // remove a callback from the delegate
             
             // try to delete the signature
-            FSignatureDesc** SignatureDesc = Function2Signature.Find(*CallbackFuncPtr);
+            FSignatureDesc** SignatureDesc = Binding2Signature.Find(FBindingKey(Callback.Object, *CallbackFuncPtr));
             if (SignatureDesc && *SignatureDesc)
             {
                 (*SignatureDesc)->MarkForDelete(false, Object);
@@ -337,17 +359,12 @@ void FDelegateHelper::Remove(FMulticastDelegateType *ScriptDelegate, UObject *Ob
 
 void FDelegateHelper::Remove(UObject* Object)
 {
-	TArray<UFunction*> FunctionsPtr = Class2Functions.FindRef(Object->GetClass());
-	for (int i = 0; i < FunctionsPtr.Num(); ++i)
+	TArray<FSignatureDesc*> Signatures = Class2Signatures.FindRef(Object->GetClass());     // copy, the signatures are cleaned up one by one
+	for (FSignatureDesc* SignatureDesc : Signatures)
 	{
-		FCallbackDesc callback = Function2Callback.FindRef(FunctionsPtr[i]);
-		if (callback.Object == Object)
+		if (SignatureDesc->Callback.Object == Object)
 		{
-			FSignatureDesc* SignatureDesc = Function2Signature.FindRef(FunctionsPtr[i]);
-			if (SignatureDesc)
-			{
-				SignatureDesc->MarkForDelete(true);
-			}
+			SignatureDesc->MarkForDelete(true);
 		}
 	}
 }
@@ -381,7 +398,7 @@ void FDelegateHelper::Clear(FMulticastDelegateType *InScriptDelegate)
             UFunction** CallbackFuncPtr = Callback2Function.Find(Callback);
             if (CallbackFuncPtr && *CallbackFuncPtr)
             {
-                FSignatureDesc** SignatureDesc = Function2Signature.Find(*CallbackFuncPtr);
+                FSignatureDesc** SignatureDesc = Binding2Signature.Find(FBindingKey(Callback.Object, *CallbackFuncPtr));
                 if (SignatureDesc && *SignatureDesc)
                 {
                     (*SignatureDesc)->MarkForDelete();
@@ -424,6 +441,13 @@ void FDelegateHelper::Broadcast(lua_State *L, FMulticastDelegateType *InScriptDe
     if (SignatureFunctionDesc && Property)
     {
         FMulticastScriptDelegate *ScriptDelegate = TMulticastDelegateTraits<FMulticastDelegateType>::GetMulticastDelegate(Property, InScriptDelegate);  // get target delegate
+        if (SignatureFunctionDesc->CanForwardLuaParams()
+            && NumParams == SignatureFunctionDesc->GetNumProperties()
+            && SignatureFunctionDesc->CheckForwardedLuaParams(L, FirstParamIndex)
+            && BroadcastToLua(L, ScriptDelegate, NumParams, FirstParamIndex))
+        {
+            return;         // all listeners are Lua callbacks
+        }
         SignatureFunctionDesc->BroadcastMulticastDelegate(L, NumParams, FirstParamIndex, ScriptDelegate);        // fire the delegate
         return;
     }
@@ -431,6 +455,76 @@ void FDelegateHelper::Broadcast(lua_State *L, FMulticastDelegateType *InScriptDe
     UE_LOG(LogUnLua, Warning, TEXT("Failed to broadcast multicast delegate!!!"));
 }
 
+/**
+ * Access the invocation list of a multicast delegate without copying it
+ */
+struct FMulticastScriptDelegateAccessor : public FMulticastScriptDelegate
+{
+    static const auto& GetInvocationList(const FMulticastScriptDelegate &ScriptDelegate)
+    {
+        return ScriptDelegate.*(&FMulticastScriptDelegateAccessor::InvocationList);
+    }
+};
+
+/**
+ * Fire a multicast delegate whose listeners are all Lua callbacks, Lua to Lua without marshalling the parameters through UE
+ */
+bool FDelegateHelper::BroadcastToLua(lua_State *L, const FMulticastScriptDelegate *ScriptDelegate, int32 NumParams, int32 FirstParamIndex)
+{
+    if (!ScriptDelegate)
+    {
+        return false;
+    }
+
+    // the callbacks are run in the order of the invocation list, as UE does
+    TArray<FSignatureDesc*, TInlineAllocator<8>> Signatures;
+    for (const FScriptDelegate &Delegate : FMulticastScriptDelegateAccessor::GetInvocationList(*ScriptDelegate))
+    {
+        UObject *Object = Delegate.GetUObject();
+        if (!Object)
+        {
+            continue;           // the object is deleted, UE skips it as well
+        }
+        UFunction *Function = Object->FindFunction(Delegate.GetFunctionName());
+        FSignatureDesc **SignatureDesc = Function ? Binding2Signature.Find(FBindingKey(Object, Function)) : nullptr;
+        if (!SignatureDesc || !*SignatureDesc)
+        {
+#if ENABLE_SHARED_DELEGATE_PROXY
+            if (IsRetiredProxy(Object, Function))
+            {
+                continue;       // a stale entry, ProcessDelegate skips it as well
+            }
+#endif
+            return false;       // native listeners, keep UE delegate semantics
+        }
+        if (!(*SignatureDesc)->bPendingKill)
+        {
+            Signatures.Add(*SignatureDesc);
+        }
+    }
+    if (Signatures.Num() < 1)
+    {
+        return false;
+    }
+
+    for (FSignatureDesc *SignatureDesc : Signatures)
+    {
+        ++SignatureDesc->NumCalls;      // a callback may remove the others, keep them alive
+    }
+    for (FSignatureDesc *SignatureDesc : Signatures)
+    {
+        if (!SignatureDesc->bPendingKill && GLuaCxt->IsUObjectValid(SignatureDesc->Callback.Object))
+        {
+            SignatureDesc->Execute(L, NumParams, FirstParamIndex);
+        }
+    }
+    for (FSignatureDesc *SignatureDesc : Signatures)
+    {
+        SignatureDesc->EndCall();
+    }
+    return true;
+}
+
 void FDelegateHelper::AddDelegate(FMulticastDelegateType *ScriptDelegate, UObject* Object, const FCallbackDesc& Callback,FScriptDelegate DynamicDelegate)
 {
     FMulticastDelegateProperty *Property = nullptr;
@@ -448,58 +542,93 @@ void FDelegateHelper::AddDelegate(FMulticastDelegateType *ScriptDelegate, UObjec
     DelegateCallbacks.AddUnique(Callback);
 }
 
-void FDelegateHelper::CleanUpByFunction(UFunction *Function)
+void FDelegateHelper::CleanUpBySignature(FSignatureDesc *SignatureDesc)
 {
-    // cleanup all associated stuff of a UFunction
-    FSignatureDesc* SignatureDesc = nullptr;
-    if (Function2Signature.RemoveAndCopyValue(Function, SignatureDesc))
+    // cleanup all associated stuff of a callback
+    UFunction *Function = SignatureDesc->SignatureFunctionDesc->GetFunction();
+    const FCallbackDesc Callback = SignatureDesc->Callback;
+    Binding2Signature.Remove(FBindingKey(Callback.Object, Function));
+    Callback2Function.Remove(Callback);
+
+    TArray<FSignatureDesc*>* SignaturesPtr = Class2Signatures.Find(Callback.Class);
+    if (SignaturesPtr)
     {
-        delete SignatureDesc;
+        SignaturesPtr->RemoveSwap(SignatureDesc);
+        if (SignaturesPtr->Num() < 1)
+        {
+            Class2Signatures.Remove(Callback.Class);
+        }
     }
 
-    FCallbackDesc Callback;
-    if (Function2Callback.RemoveAndCopyValue(Function, Callback))
+    delete SignatureDesc;
+
+#if ENABLE_SHARED_DELEGATE_PROXY
+    RetiredProxies.FindOrAdd(Callback.Object).Add(Function);        // UE delegates may still name the proxy, never reuse it for the object
+#else
+    RemoveUFunction(Function, Callback.Class);       // remove the duplicated function
+#endif
+}
+
+void FDelegateHelper::CleanUpByClass(UClass *Class)
+{
+    // cleanup all associated stuff of a UClass
+    TArray<FSignatureDesc*> Signatures;
+    if (Class2Signatures.RemoveAndCopyValue(Class, Signatures))
     {
-        Callback2Function.Remove(Callback);
+        for (FSignatureDesc *SignatureDesc : Signatures)
+        {
+            CleanUpBySignature(SignatureDesc);
+        }
+    }
 
-        TArray<UFunction*>* FunctionsPtr = Class2Functions.Find(Callback.Class);
-        if (FunctionsPtr)
+#if ENABLE_SHARED_DELEGATE_PROXY
+    for (TMap<TPair<UClass*, UFunction*>, FProxyFunctions>::TIterator It(ProxyFunctions); It; ++It)
+    {
+        if (It.Key().Key != Class)
+        {
+            continue;
+        }
+        if (It.Value().Class.Get() == Class)
         {
-            FunctionsPtr->Remove(Function);
-            if (FunctionsPtr->Num() < 1)
+            for (UFunction *Function : It.Value().Functions)
             {
-                Class2Functions.Remove(Callback.Class);
+                RemoveUFunction(Function, Class);       // remove the proxy functions
             }
         }
-
-        RemoveUFunction(Function, Callback.Class);       // remove the duplicated function
+        It.RemoveCurrent();
     }
-}
-
-void FDelegateHelper::CleanUpByClass(UClass *Class)
-{
-    // cleanup all associated stuff of a UClass
-    TArray<UFunction*> Functions;
-    if (Class2Functions.RemoveAndCopyValue(Class, Functions))
+    for (TMap<UObject*, TArray<UFunction*>>::TIterator It(RetiredProxies); It; ++It)
     {
-        for (UFunction *Function : Functions)
+        if (It.Key()->GetClass() == Class)
         {
-            CleanUpByFunction(Function);
+            It.RemoveCurrent();
         }
     }
+#endif
 }
 
 void FDelegateHelper::Cleanup(bool bFullCleanup)
 {
     // cleanup all stuff during level transition
-    for (TMap<UClass*, TArray<UFunction*>>::TIterator It(Class2Functions); It; ++It)
+    TArray<UClass*> Classes;
+    Class2Signatures.GetKeys(Classes);
+#if ENABLE_SHARED_DELEGATE_PROXY
+    for (TMap<TPair<UClass*, UFunction*>, FProxyFunctions>::TConstIterator It(ProxyFunctions); It; ++It)
+    {
+        Classes.AddUnique(It.Key().Key);
+    }
+#endif
+    for (UClass *Class : Classes)
     {
-        CleanUpByClass(It.Key());
+        CleanUpByClass(Class);
     }
-    Class2Functions.Empty();
-    Function2Signature.Empty();
+    Class2Signatures.Empty();
+    Binding2Signature.Empty();
     Callback2Function.Empty();
-    Function2Callback.Empty();
+#if ENABLE_SHARED_DELEGATE_PROXY
+    ProxyFunctions.Empty();
+    RetiredProxies.Empty();
+#endif
 
     for (TMap<FScriptDelegate*, FFunctionDesc*>::TIterator It(Delegate2Signatures); It; ++It)
     {
@@ -522,25 +651,56 @@ void FDelegateHelper::Cleanup(bool bFullCleanup)
 void FDelegateHelper::NotifyUObjectDeleted(UObject* InObject)
 {   
     Remove(InObject);
+#if ENABLE_SHARED_DELEGATE_PROXY
+    RetiredProxies.Remove(InObject);        // the delegates don't resolve a deleted object, even if its address is reused
+#endif
+}
+
+/**
+ * Build a unique name for the UFunction duplicated for a callback
+ */
+FName FDelegateHelper::MakeSignatureName(const TCHAR *DelegateType, UObject *Object, FProperty *Property)
+{
+#if ENABLE_SHARED_DELEGATE_PROXY
+    return NAME_None;           // a shared proxy UFunction is picked by 'CreateSignature'
+#else
+    lua_State* L = UnLua::GetState();
+    lua_Debug ar;
+
+    lua_getstack(L, 1, &ar);
+    lua_getinfo(L, "nSl", &ar);
+    int line = ar.linedefined;
+    auto name = ar.source;
+
+    return FName(*FString::Printf(TEXT("LuaFunc:[%s:%d]_%s:[%s.%s_%s]"), ANSI_TO_TCHAR(name), line, DelegateType, *Object->GetName(), *Property->GetName(), *FGuid::NewGuid().ToString()));
+#endif
 }
 
 /**
- * 1. Create a new signature UFunction
+ * 1. Create a new signature UFunction, or pick a shared proxy UFunction
  * 2. Set a custom thunk function for the new signature
  * 3. Create a signature descriptor
  * 4. Update function flags for the new signature if necessary
  * 5. Update cached infos
  */
-void FDelegateHelper::CreateSignature(UFunction *TemplateFunction, FName FuncName, const FCallbackDesc &Callback, int32 CallbackRef)
+UFunction* FDelegateHelper::CreateSignature(UFunction *TemplateFunction, FName FuncName, const FCallbackDesc &Callback, int32 CallbackRef)
 {
+#if ENABLE_SHARED_DELEGATE_PROXY
+    UFunction *SignatureFunction = AcquireProxyFunction(TemplateFunction, Callback);
+    FFunctionDesc *SignatureFunctionDesc = GReflectionRegistry.RegisterFunction(SignatureFunction);
+#else
     UFunction *SignatureFunction = DuplicateUFunction(TemplateFunction, Callback.Class, FuncName);      // duplicate the signature UFunction
     SignatureFunction->Script.Empty();
+    FFunctionDesc *SignatureFunctionDesc = GReflectionRegistry.RegisterFunction(SignatureFunction, CallbackRef);
+#endif
 
     FSignatureDesc *SignatureDesc = new FSignatureDesc;
-    SignatureDesc->SignatureFunctionDesc = GReflectionRegistry.RegisterFunction(SignatureFunction, CallbackRef);
+    SignatureDesc->SignatureFunctionDesc = SignatureFunctionDesc;
+    SignatureDesc->Callback = Callback;
     SignatureDesc->CallbackRef = CallbackRef;
-    Function2Signature.Add(SignatureFunction, SignatureDesc);
+    Binding2Signature.Add(FBindingKey(Callback.Object, SignatureFunction), SignatureDesc);
 
+#if !ENABLE_SHARED_DELEGATE_PROXY
     OverrideUFunction(SignatureFunction, (FNativeFuncPtr)&FDelegateHelper::ProcessDelegate, SignatureDesc, false);      // set custom thunk function for the duplicated UFunction
 
     uint8 NumRefProperties = SignatureDesc->SignatureFunctionDesc->GetNumRefProperties();
@@ -548,10 +708,61 @@ void FDelegateHelper::CreateSignature(UFunction *TemplateFunction, FName FuncNam
     {
         SignatureFunction->FunctionFlags |= FUNC_HasOutParms;        // 'FUNC_HasOutParms' will not be set for signature function even if it has out parameters
     }
+#endif
 
     Callback2Function.Add(Callback, SignatureFunction);
-    Function2Callback.Add(SignatureFunction, Callback);
 
-    TArray<UFunction*> &Functions = Class2Functions.FindOrAdd(Callback.Class);
-    Functions.Add(SignatureFunction);
-}
\ No newline at end of file
+    TArray<FSignatureDesc*> &Signatures = Class2Signatures.FindOrAdd(Callback.Class);
+    Signatures.Add(SignatureDesc);
+    return SignatureFunction;
+}
+
+#if ENABLE_SHARED_DELEGATE_PROXY
+/**
+ * Pick a proxy UFunction of the signature that the callback's object has never used, the proxies are shared by all instances of the class.
+ * A proxy unbound by the object isn't reused for it, a UE delegate may still name it, e.g. a callback unbound by Unbind({Object, Callback}),
+ * removed when its userdata is collected, or a copy of the invocation list during a broadcast
+ */
+UFunction* FDelegateHelper::AcquireProxyFunction(UFunction *TemplateFunction, const FCallbackDesc &Callback)
+{
+    FProxyFunctions &Proxies = ProxyFunctions.FindOrAdd(TPair<UClass*, UFunction*>(Callback.Class, TemplateFunction));
+    if (Proxies.Class.Get() != Callback.Class)
+    {
+        Proxies.Class = Callback.Class;
+        Proxies.Functions.Empty();
+    }
+
+    const TArray<UFunction*> *Retired = RetiredProxies.Find(Callback.Object);
+    for (UFunction *Proxy : Proxies.Functions)
+    {
+        if (!Binding2Signature.Contains(FBindingKey(Callback.Object, Proxy)) && (!Retired || !Retired->Contains(Proxy)))
+        {
+            return Proxy;
+        }
+    }
+
+    // the names only differ in number, so no new entry is added to the name table
+    static const FName ProxyName(TEXT("LuaDelegateProxy"));
+    UFunction *Proxy = DuplicateUFunction(TemplateFunction, Callback.Class, FName(ProxyName, ++NumProxyFunctions));
+    Proxy->Script.Empty();
+    OverrideUFunction(Proxy, (FNativeFuncPtr)&FDelegateHelper::ProcessDelegate, nullptr, false);      // set custom thunk function for the proxy
+
+    uint8 NumRefProperties = GReflectionRegistry.RegisterFunction(Proxy)->GetNumRefProperties();
+    if (NumRefProperties > 0)
+    {
+        Proxy->FunctionFlags |= FUNC_HasOutParms;        // 'FUNC_HasOutParms' will not be set for signature function even if it has out parameters
+    }
+
+    Proxies.Functions.Add(Proxy);
+    return Proxy;
+}
+
+/**
+ * Test if an object has unbound the proxy UFunction, the delegates still naming it are stale
+ */
+bool FDelegateHelper::IsRetiredProxy(UObject *Object, UFunction *Function)
+{
+    const TArray<UFunction*> *Retired = Function ? RetiredProxies.Find(Object) : nullptr;
+    return Retired && Retired->Contains(Function);
+}
+#endif
@@ -17,6 +17,8 @@
 #include "CoreUObject.h"
 #include "UnLuaCompatibility.h"
 
+#define ENABLE_SHARED_DELEGATE_PROXY 1              // option to route the Lua callbacks of a delegate signature through shared proxy UFunctions instead of duplicating a UFunction per callback
+
 struct FCallbackDesc
 {
     FCallbackDesc()
@@ -50,6 +52,8 @@ FORCEINLINE uint32 GetTypeHash(const FCallbackDesc &Callback)
     return Callback.Hash;
 }
 
+struct lua_State;
+
 struct FSignatureDesc
 {
     FSignatureDesc()
@@ -59,16 +63,17 @@ struct FSignatureDesc
     void MarkForDelete(bool bIgnoreBindings = false, UObject* Object = nullptr);
 
     void Execute(UObject *Context, FFrame &Stack, void *RetValueAddress);
+    void Execute(lua_State *L, int32 NumParams, int32 FirstParamIndex);
+    void EndCall();
 
     class FFunctionDesc *SignatureFunctionDesc;
+    FCallbackDesc Callback;
     int32 CallbackRef;
     int16 NumCalls;
     uint16 NumBindings : 15;
     uint16 bPendingKill : 1;
 };
 
-struct lua_State;
-
 #if ENGINE_MAJOR_VERSION <= 4 && ENGINE_MINOR_VERSION < 23
 typedef FMulticastScriptDelegate FMulticastDelegateType;
 #else
@@ -101,14 +106,22 @@ public:
 
     static void AddDelegate(FMulticastDelegateType *ScriptDelegate, UObject* Object, const FCallbackDesc& Callback,FScriptDelegate DynamicDelegate);
 
-    static void CleanUpByFunction(UFunction *Function);
+    static void CleanUpBySignature(FSignatureDesc *SignatureDesc);
     static void CleanUpByClass(UClass *Class);
     static void Cleanup(bool bFullCleanup);
 
     static void NotifyUObjectDeleted(UObject* InObject);
 
 private:
-    static void CreateSignature(UFunction *TemplateFunction, FName FuncName, const FCallbackDesc &Callback, int32 CallbackRef);
+    static bool BroadcastToLua(lua_State *L, const FMulticastScriptDelegate *ScriptDelegate, int32 NumParams, int32 FirstParamIndex);
+    static FName MakeSignatureName(const TCHAR *DelegateType, UObject *Object, FProperty *Property);
+    static UFunction* CreateSignature(UFunction *TemplateFunction, FName FuncName, const FCallbackDesc &Callback, int32 CallbackRef);
+#if ENABLE_SHARED_DELEGATE_PROXY
+    static UFunction* AcquireProxyFunction(UFunction *TemplateFunction, const FCallbackDesc &Callback);
+    static bool IsRetiredProxy(UObject *Object, UFunction *Function);
+#endif
+
+    typedef TPair<UObject*, UFunction*> FBindingKey;            // bound object and bound UFunction of a delegate
 
     static TMap<FScriptDelegate*, FDelegateProperty*> Delegate2Property;
     static TMap<FMulticastDelegateType*, FMulticastDelegateProperty*> MulticastDelegate2Property;
@@ -116,12 +129,23 @@ private:
     static TMap<FScriptDelegate*, FFunctionDesc*> Delegate2Signatures;
     static TMap<FMulticastDelegateType*, FFunctionDesc*> MulticastDelegate2Signatures;
 
-    static TMap<UFunction*, FSignatureDesc*> Function2Signature;
+    static TMap<FBindingKey, FSignatureDesc*> Binding2Signature;
 
     static TMap<FCallbackDesc, UFunction*> Callback2Function;
-    static TMap<UFunction*, FCallbackDesc> Function2Callback;
 
-    static TMap<UClass*, TArray<UFunction*>> Class2Functions;
+    static TMap<UClass*, TArray<FSignatureDesc*>> Class2Signatures;
+
+#if ENABLE_SHARED_DELEGATE_PROXY
+    struct FProxyFunctions
+    {
+        FWeakObjectPtr Class;               // detects a deleted class whose address is reused
+        TArray<UFunction*> Functions;       // an instance binds its callbacks of the signature through different proxies
+    };
+
+    static TMap<TPair<UClass*, UFunction*>, FProxyFunctions> ProxyFunctions;   // (class, signature) -> proxy UFunctions shared by the instances
+    static TMap<UObject*, TArray<UFunction*>> RetiredProxies;                 // proxies an object has unbound, UE delegates may still name them until the object is deleted
+    static int32 NumProxyFunctions;
+#endif
 
 	// this data structure is just for clear multi delegate function, cannot use for other purpose, 
     // because multi delegate may be reused by buffer memory, 
@@ -0,0 +1,146 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#include "LuaAllocator.h"
+#include "UnLuaPrivate.h"
+
+FLuaSmallObjectPool::FLuaSmallObjectPool()
+{
+    FMemory::Memzero(AvailablePages, sizeof(AvailablePages));
+}
+
+FLuaSmallObjectPool::~FLuaSmallObjectPool()
+{
+    Empty();
+}
+
+/**
+ * Allocate a page for a size class that is out of free blocks
+ */
+FLuaSmallObjectPool::FPage* FLuaSmallObjectPool::NewPage(int32 SizeClass)
+{
+    FPage *Page = (FPage*)FMemory::Malloc(PageSize, PageSize);     // aligned to its size, see 'Free'
+    Page->FreeList = nullptr;
+    Page->Prev = Page->Next = nullptr;
+    Page->NumUsed = 0;
+    Page->CarveOffset = PageHeaderSize;
+    Page->SizeClass = SizeClass;
+    Page->PageIndex = Pages.Add(Page);
+    Link(Page);
+    INC_MEMORY_STAT_BY(STAT_UnLua_LuaPool_Memory, PageSize);
+    return Page;
+}
+
+/**
+ * Return an empty page to FMemory
+ */
+void FLuaSmallObjectPool::ReleasePage(FPage *Page)
+{
+    Unlink(Page);
+    Pages.RemoveAtSwap(Page->PageIndex, 1, false);
+    if (Pages.IsValidIndex(Page->PageIndex))
+    {
+        Pages[Page->PageIndex]->PageIndex = Page->PageIndex;
+    }
+    FMemory::Free(Page);
+    DEC_MEMORY_STAT_BY(STAT_UnLua_LuaPool_Memory, PageSize);
+}
+
+void FLuaSmallObjectPool::Empty()
+{
+    for (FPage *Page : Pages)
+    {
+        FMemory::Free(Page);
+    }
+    DEC_MEMORY_STAT_BY(STAT_UnLua_LuaPool_Memory, Pages.Num() * PageSize);
+    Pages.Empty();
+    FMemory::Memzero(AvailablePages, sizeof(AvailablePages));
+}
+
+/**
+ * Track the memory used by Lua. for a new block, 'osize' is the type of the object instead of a size
+ */
+static FORCEINLINE void AccountLuaMemory(void *ptr, size_t osize, size_t nsize)
+{
+    const size_t OldSize = ptr ? osize : 0;
+    if (nsize > OldSize)
+    {
+        INC_MEMORY_STAT_BY(STAT_UnLua_Lua_Memory, nsize - OldSize);
+    }
+    else
+    {
+        DEC_MEMORY_STAT_BY(STAT_UnLua_Lua_Memory, OldSize - nsize);
+    }
+}
+
+void* LuaDefaultAllocator(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+    AccountLuaMemory(ptr, osize, nsize);
+
+    if (nsize == 0)
+    {
+        FMemory::Free(ptr);
+        return nullptr;
+    }
+    return ptr ? FMemory::Realloc(ptr, nsize) : FMemory::Malloc(nsize);
+}
+
+void* LuaPooledAllocator(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+    AccountLuaMemory(ptr, osize, nsize);
+
+    FLuaSmallObjectPool *Pool = (FLuaSmallObjectPool*)ud;
+    const bool bOldPooled = ptr && FLuaSmallObjectPool::IsPooled(osize);
+    if (nsize == 0)
+    {
+        if (bOldPooled)
+        {
+            Pool->Free(ptr, osize);
+        }
+        else
+        {
+            FMemory::Free(ptr);
+        }
+        return nullptr;
+    }
+
+    const bool bNewPooled = FLuaSmallObjectPool::IsPooled(nsize);
+    if (!ptr)
+    {
+        return bNewPooled ? Pool->Alloc(nsize) : FMemory::Malloc(nsize);
+    }
+
+    if (!bOldPooled && !bNewPooled)
+    {
+        return FMemory::Realloc(ptr, nsize);
+    }
+    if (bOldPooled && bNewPooled && FLuaSmallObjectPool::IsSameSizeClass(osize, nsize))
+    {
+        return ptr;
+    }
+
+    // the block moves between the pool and FMemory, or between size classes
+    void *Buffer = bNewPooled ? Pool->Alloc(nsize) : FMemory::Malloc(nsize);
+    FMemory::Memcpy(Buffer, ptr, FMath::Min(osize, nsize));
+    if (bOldPooled)
+    {
+        Pool->Free(ptr, osize);
+    }
+    else
+    {
+        FMemory::Free(ptr);
+    }
+    return Buffer;
+}
@@ -0,0 +1,171 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Size-classed pool for small Lua objects (tables, closures, short strings, ...) in front of FMemory.
+ *
+ * Every page holds blocks of a single size class and is aligned to its size, so the page of a block is found from its
+ * address and no per-block header is needed. A page is returned to FMemory once all its blocks are freed, unless it's
+ * the last page of its size class with free blocks. Not thread safe, a pool belongs to a single Lua state.
+ */
+class UNLUA_API FLuaSmallObjectPool
+{
+public:
+    enum
+    {
+        MaxBlockSize = 256,
+        Granularity = 16,
+        NumSizeClasses = MaxBlockSize / Granularity,
+        PageSize = 16 * 1024,
+    };
+
+    FLuaSmallObjectPool();
+    ~FLuaSmallObjectPool();
+
+    FORCEINLINE static bool IsPooled(size_t Size) { return Size - 1 < MaxBlockSize; }      // 0 < Size <= MaxBlockSize
+
+    FORCEINLINE void* Alloc(size_t Size)
+    {
+        const int32 SizeClass = GetSizeClass(Size);
+        FPage *Page = AvailablePages[SizeClass];
+        if (!Page)
+        {
+            Page = NewPage(SizeClass);
+        }
+
+        void *Block = Page->FreeList;
+        if (Block)
+        {
+            Page->FreeList = Page->FreeList->Next;
+        }
+        else
+        {
+            Block = (uint8*)Page + Page->CarveOffset;
+            Page->CarveOffset += GetBlockSize(SizeClass);
+        }
+        ++Page->NumUsed;
+
+        if (IsFull(Page))
+        {
+            Unlink(Page);
+        }
+        return Block;
+    }
+
+    FORCEINLINE void Free(void *Ptr, size_t Size)
+    {
+        FPage *Page = (FPage*)((UPTRINT)Ptr & ~(UPTRINT)(PageSize - 1));
+        const bool bWasFull = IsFull(Page);
+
+        FFreeBlock *Block = (FFreeBlock*)Ptr;
+        Block->Next = Page->FreeList;
+        Page->FreeList = Block;
+        --Page->NumUsed;
+
+        if (bWasFull)
+        {
+            Link(Page);
+        }
+        else if (Page->NumUsed == 0 && (Page->Prev || Page->Next))
+        {
+            ReleasePage(Page);              // keep the page only if it's the last one with free blocks in its size class
+        }
+    }
+
+    FORCEINLINE static bool IsSameSizeClass(size_t SizeA, size_t SizeB) { return GetSizeClass(SizeA) == GetSizeClass(SizeB); }
+
+    FORCEINLINE int32 GetNumPages() const { return Pages.Num(); }
+
+    /**
+     * Release all pages, blocks must not be used any more (i.e. the Lua state has been closed)
+     */
+    void Empty();
+
+private:
+    struct FFreeBlock
+    {
+        FFreeBlock *Next;
+    };
+
+    /**
+     * Header at the start of every page
+     */
+    struct FPage
+    {
+        FFreeBlock *FreeList;       // freed blocks of this page
+        FPage *Prev;                // pages with free blocks of the same size class
+        FPage *Next;
+        int32 NumUsed;
+        int32 CarveOffset;          // blocks from here to the end of the page have never been used
+        int32 SizeClass;
+        int32 PageIndex;            // index in 'Pages'
+    };
+
+    enum
+    {
+        PageHeaderSize = (sizeof(FPage) + Granularity - 1) / Granularity * Granularity,
+    };
+
+    FORCEINLINE static int32 GetSizeClass(size_t Size) { return (int32)((Size - 1) / Granularity); }
+
+    FORCEINLINE static int32 GetBlockSize(int32 SizeClass) { return (SizeClass + 1) * Granularity; }
+
+    FORCEINLINE static bool IsFull(const FPage *Page) { return !Page->FreeList && Page->CarveOffset + GetBlockSize(Page->SizeClass) > PageSize; }
+
+    FORCEINLINE void Link(FPage *Page)
+    {
+        FPage *&Head = AvailablePages[Page->SizeClass];
+        Page->Prev = nullptr;
+        Page->Next = Head;
+        if (Head)
+        {
+            Head->Prev = Page;
+        }
+        Head = Page;
+    }
+
+    FORCEINLINE void Unlink(FPage *Page)
+    {
+        if (Page->Prev)
+        {
+            Page->Prev->Next = Page->Next;
+        }
+        else
+        {
+            AvailablePages[Page->SizeClass] = Page->Next;
+        }
+        if (Page->Next)
+        {
+            Page->Next->Prev = Page->Prev;
+        }
+        Page->Prev = Page->Next = nullptr;
+    }
+
+    FPage* NewPage(int32 SizeClass);
+    void ReleasePage(FPage *Page);
+
+    FPage *AvailablePages[NumSizeClasses];      // pages with free blocks, per size class
+    TArray<FPage*> Pages;
+};
+
+/**
+ * Allocators for 'lua_newstate'. memory is accounted from 'osize'/'nsize' only, Lua passes the exact size of every block
+ */
+UNLUA_API void* LuaDefaultAllocator(void *ud, void *ptr, size_t osize, size_t nsize);
+UNLUA_API void* LuaPooledAllocator(void *ud, void *ptr, size_t osize, size_t nsize);      // 'ud' is the FLuaSmallObjectPool
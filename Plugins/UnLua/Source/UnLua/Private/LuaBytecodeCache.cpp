@@ -0,0 +1,121 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#include "LuaBytecodeCache.h"
+#include "UnLuaPrivate.h"
+#include "Hash/CityHash.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "lua.hpp"
+
+FLuaBytecodeCache GLuaBytecodeCache;
+
+static int WriteBytecode(lua_State *L, const void *Data, size_t Size, void *UserData)
+{
+    ((TArray<uint8>*)UserData)->Append((const uint8*)Data, Size);
+    return 0;
+}
+
+FLuaBytecodeCache::FLuaBytecodeCache()
+{
+}
+
+FString FLuaBytecodeCache::GetCacheFilePath(const char *ChunkName)
+{
+    if (CacheDir.IsEmpty())
+    {
+        CacheDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("UnLua/BytecodeCache"));
+    }
+    const uint64 Hash = CityHash64WithSeed(ChunkName, FCStringAnsi::Strlen(ChunkName), LUA_VERSION_NUM);
+    return FString::Printf(TEXT("%s/%016llx.luac"), *CacheDir, (unsigned long long)Hash);
+}
+
+int32 FLuaBytecodeCache::Load(lua_State *L, const char *Source, int32 SourceSize, const char *ChunkName, const char *Mode)
+{
+    SCOPE_CYCLE_COUNTER(STAT_UnLua_LoadModule);
+
+    const double StartTime = FPlatformTime::Seconds();
+    bool bFromBytecodeCache = false;
+    int32 Code = LUA_ERRERR;
+
+    const bool bIsSource = SourceSize < 1 || Source[0] != LUA_SIGNATURE[0];     // precompiled chunks are loaded as they are
+    const bool bAllowBinary = !Mode || FCStringAnsi::Strchr(Mode, 'b');
+    if (UNLUA_ENABLE_BYTECODE_CACHE && bIsSource && bAllowBinary)
+    {
+        const FString CacheFilePath = GetCacheFilePath(ChunkName);
+        const uint64 SourceHash = CityHash64(Source, SourceSize);
+
+        TArray<uint8> Data;
+        if (FFileHelper::LoadFileToArray(Data, *CacheFilePath, FILEREAD_Silent) && Data.Num() > (int32)sizeof(uint64) && FMemory::Memcmp(Data.GetData(), &SourceHash, sizeof(uint64)) == 0)
+        {
+            Code = luaL_loadbufferx(L, (const char*)Data.GetData() + sizeof(uint64), Data.Num() - sizeof(uint64), ChunkName, "b");
+            bFromBytecodeCache = Code == LUA_OK;
+            if (!bFromBytecodeCache)
+            {
+                UE_LOG(LogUnLua, Warning, TEXT("Invalid bytecode cache for %s, rebuild it"), UTF8_TO_TCHAR(ChunkName));
+                lua_pop(L, 1);
+            }
+        }
+
+        if (!bFromBytecodeCache)
+        {
+            Code = luaL_loadbufferx(L, Source, SourceSize, ChunkName, Mode);
+            if (Code == LUA_OK)
+            {
+                Data.Reset();
+                Data.Append((const uint8*)&SourceHash, sizeof(uint64));
+                lua_dump(L, WriteBytecode, &Data, 0);                   // keep debug info for error messages and debuggers
+                if (!FFileHelper::SaveArrayToFile(Data, *CacheFilePath))
+                {
+                    UE_LOG(LogUnLua, Warning, TEXT("Failed to write bytecode cache %s"), *CacheFilePath);
+                }
+            }
+        }
+    }
+    else
+    {
+        Code = luaL_loadbufferx(L, Source, SourceSize, ChunkName, Mode);
+    }
+
+    UnLua::FModuleLoadStats &Stats = ModuleLoadStats.FindOrAdd(UTF8_TO_TCHAR(ChunkName));
+    Stats.LoadTime = FPlatformTime::Seconds() - StartTime;
+    Stats.SourceSize = SourceSize;
+    Stats.bFromBytecodeCache = bFromBytecodeCache;
+    ++Stats.NumLoads;
+
+    return Code;
+}
+
+/**
+ * Log load statistics of all modules, slowest first
+ */
+void FLuaBytecodeCache::DumpModuleLoadStats() const
+{
+    TArray<FString> ModuleNames;
+    ModuleLoadStats.GetKeys(ModuleNames);
+    ModuleNames.Sort([this](const FString &A, const FString &B) { return ModuleLoadStats[A].LoadTime > ModuleLoadStats[B].LoadTime; });
+
+    double TotalTime = 0.0;
+    int32 NumCacheHits = 0;
+    for (const FString &ModuleName : ModuleNames)
+    {
+        const UnLua::FModuleLoadStats &Stats = ModuleLoadStats[ModuleName];
+        TotalTime += Stats.LoadTime;
+        NumCacheHits += Stats.bFromBytecodeCache ? 1 : 0;
+        UE_LOG(LogUnLua, Log, TEXT("%8.3f ms %8d bytes %s %s"), Stats.LoadTime * 1000.0, Stats.SourceSize, Stats.bFromBytecodeCache ? TEXT("[bytecode]") : TEXT("[source]  "), *ModuleName);
+    }
+    UE_LOG(LogUnLua, Log, TEXT("%d modules loaded in %.3f ms, %d from bytecode cache"), ModuleNames.Num(), TotalTime * 1000.0, NumCacheHits);
+}
@@ -0,0 +1,54 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#pragma once
+
+#include "UnLuaBase.h"
+
+/**
+ * Cache of precompiled Lua bytecode for script files.
+ *
+ * There is one entry per chunk name (and Lua version), it starts with a hash of the source followed by the dumped
+ * bytecode. A modified (or hot fixed) file doesn't match the hash and its entry is rebuilt from source, so are invalid
+ * or truncated entries which fail to load as bytecode.
+ */
+class UNLUA_API FLuaBytecodeCache
+{
+public:
+    FLuaBytecodeCache();
+
+    /**
+     * Load a file chunk, from cached bytecode if possible. same results as 'luaL_loadbufferx'
+     *
+     * @return - status code of loading the chunk
+     */
+    int32 Load(lua_State *L, const char *Source, int32 SourceSize, const char *ChunkName, const char *Mode);
+
+    FORCEINLINE const TMap<FString, UnLua::FModuleLoadStats>& GetModuleLoadStats() const { return ModuleLoadStats; }
+
+    void DumpModuleLoadStats() const;
+
+    /**
+     * Get the path of the cache file of a chunk
+     */
+    FString GetCacheFilePath(const char *ChunkName);
+
+private:
+
+    FString CacheDir;
+    TMap<FString, UnLua::FModuleLoadStats> ModuleLoadStats;
+};
+
+extern UNLUA_API FLuaBytecodeCache GLuaBytecodeCache;
@@ -26,6 +26,7 @@
 #include "ReflectionUtils/PropertyCreator.h"
 #include "DefaultParamCollection.h"
 #include "ReflectionUtils/ReflectionRegistry.h"
+#include "LuaScriptArchive.h"
 
 // ADD_LuaPanda
 #include "LibLuasocket.h"
@@ -94,7 +95,9 @@ void FLuaContext::RegisterDelegates()
     FCoreDelegates::OnHandleSystemError.AddRaw(this, &FLuaContext::OnCrash);
     FCoreDelegates::OnHandleSystemEnsure.AddRaw(this, &FLuaContext::OnCrash);
     FCoreUObjectDelegates::PostLoadMapWithWorld.AddRaw(this, &FLuaContext::PostLoadMapWithWorld);
-    //FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddRaw(this, &FLuaContext::OnPreGarbageCollect);
+    FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddRaw(this, &FLuaContext::OnPreGarbageCollect);
+    OnPostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FLuaContext::OnPostGarbageCollect);
+    FWorldDelegates::OnWorldTickStart.AddRaw(this, &FLuaContext::OnWorldTick);                     // per frame work, see FLuaContext::Tick
 
 #if WITH_EDITOR
     FEditorDelegates::PreBeginPIE.AddRaw(this, &FLuaContext::PreBeginPIE);
@@ -109,7 +112,7 @@ void FLuaContext::RegisterDelegates()
 /**
  * Create Lua state (main thread) and register/create base libs/tables/classes
  */
-void FLuaContext::CreateState()
+void FLuaContext::CreateState(UnLua::ELuaAllocator Allocator)
 {
 #if SUPPORTS_COMMANDLET == 0
     if (IsRunningCommandlet())
@@ -121,29 +124,31 @@ void FLuaContext::CreateState()
     if (!L)
     {
 
-        L = lua_newstate(FLuaContext::LuaAllocator, nullptr);       // create main Lua thread
+        if (Allocator == UnLua::ELuaAllocator::SmallObjectPool)
+        {
+            L = lua_newstate(LuaPooledAllocator, &LuaPool);         // create main Lua thread
+        }
+        else
+        {
+            L = lua_newstate(LuaDefaultAllocator, nullptr);
+        }
         check(L);
+        CoroutineScheduler.Initialize(L);                           // before any coroutine is created
         luaL_openlibs(L);                                           // open all standard Lua libraries
 
-        AddSearcher(LoadFromCustomLoader, 2);
-        AddSearcher(LoadFromFileSystem, 3);
-        AddSearcher(LoadFromBuiltinLibs, 4);
-
-        lua_pushstring(L, "ObjectMap");                             // create weak table 'ObjectMap'
-        CreateWeakValueTable(L);
-        lua_rawset(L, LUA_REGISTRYINDEX);
-
-        lua_pushstring(L, "StructMap");                             // create weak table 'StructMap'
-        CreateWeakValueTable(L);
-        lua_rawset(L, LUA_REGISTRYINDEX);
+#if !WITH_EDITOR
+        if (!GLuaScriptArchive.IsMounted())
+        {
+            GLuaScriptArchive.Mount(FLuaScriptArchive::GetDefaultPath());     // optional, see UUnLuaScriptArchiveCommandlet
+        }
+#endif
 
-        lua_pushstring(L, "ScriptContainerMap");                    // create weak table 'ScriptContainerMap'
-        CreateWeakValueTable(L);
-        lua_rawset(L, LUA_REGISTRYINDEX);
+        AddSearcher(LoadFromCustomLoader, 2);
+        AddSearcher(LoadFromScriptArchive, 3);
+        AddSearcher(LoadFromFileSystem, 4);
+        AddSearcher(LoadFromBuiltinLibs, 5);
 
-        lua_pushstring(L, "ArrayMap");                              // create weak table 'ArrayMap'
-        CreateWeakValueTable(L);
-        lua_rawset(L, LUA_REGISTRYINDEX);
+        CreateRegistryTables(L);                                    // create tables 'ObjectMap', 'StructMap', 'ScriptContainerMap', 'ArrayMap' and 'NameCache'
 
         CreateNamespaceForUE(L);                                    // create 'UE' namespace (table)
 
@@ -159,6 +164,9 @@ void FLuaContext::CreateState()
         lua_register(L, "UnLua_RemoveFromClassWhiteSet", Global_RemoveFromClassWhiteSet);
         lua_register(L, "UnLua_UnRegisterClass", Global_UnRegisterClass);
 
+        lua_register(L, "UnLua_StartCoroutine", Global_StartCoroutine);
+        lua_register(L, "UnLua_WaitSeconds", Global_WaitSeconds);
+
         lua_register(L, "UEPrint", Global_Print);
 
         // register collision related enums
@@ -171,7 +179,7 @@ void FLuaContext::CreateState()
         {
             FUnLuaDelegates::ConfigureLuaGC.Execute(L);
         }
-        else
+        else if (!GCController.Initialize(L))
         {
 #if 504 == LUA_VERSION_NUM
             lua_gc(L, LUA_GCGEN);
@@ -352,10 +360,85 @@ TSharedPtr<UnLua::ITypeInterface> FLuaContext::FindTypeInterface(FName Name)
     return TypeInterfacePtr ? *TypeInterfacePtr : TSharedPtr<UnLua::ITypeInterface>();
 }
 
+/**
+ * Enable/disable eager metatable population for a class. an already registered metatable is populated immediately
+ */
+void FLuaContext::SetEagerClassRegistration(const UStruct *Struct, bool bEager)
+{
+    if (!Struct)
+    {
+        return;
+    }
+
+    if (!bEager)
+    {
+        EagerRegistrationStructs.Remove(TWeakObjectPtr<const UStruct>(Struct));
+        return;
+    }
+
+    EagerRegistrationStructs.Add(TWeakObjectPtr<const UStruct>(Struct));
+    if (L)
+    {
+        FString ClassName = FString::Printf(TEXT("%s%s"), Struct->GetPrefixCPP(), *Struct->GetName());
+        FClassDesc *ClassDesc = GReflectionRegistry.FindClass(TCHAR_TO_UTF8(*ClassName));
+        if (ClassDesc)
+        {
+            int32 Type = luaL_getmetatable(L, TCHAR_TO_UTF8(*ClassName));
+            if (Type == LUA_TTABLE)
+            {
+                PopulateClassMetatable(L, ClassDesc);
+            }
+            lua_pop(L, 1);
+        }
+    }
+}
+
+/**
+ * Test whether a class or one of its super classes is configured for eager metatable population
+ */
+bool FLuaContext::IsEagerClassRegistration(const UStruct *Struct) const
+{
+    if (EagerRegistrationStructs.Num() < 1)
+    {
+        return false;
+    }
+
+    for (; Struct; Struct = Struct->GetSuperStruct())
+    {
+        if (EagerRegistrationStructs.Contains(TWeakObjectPtr<const UStruct>(Struct)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static constexpr EInternalObjectFlags AsyncObjectFlags = EInternalObjectFlags::AsyncLoading | EInternalObjectFlags::Async;
+
+/**
+ * Test if an object is created by the loader and its loading is not finished yet
+ */
+static bool IsLoadingObject(const UObject *Object)
+{
+    if (Object->GetClass()->HasAnyInternalFlags(AsyncObjectFlags))
+    {
+        return true;
+    }
+
+    for (; Object; Object = Object->GetOuter())
+    {
+        if (Object->HasAnyFlags(RF_NeedLoad | RF_NeedPostLoad) || Object->HasAnyInternalFlags(AsyncObjectFlags))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * Try to bind Lua module for a UObject
  */
-bool FLuaContext::TryToBindLua(UObject* Object)
+bool FLuaContext::TryToBindLua(UObject* Object, bool bFromBindBatch)
 {
     if (!bEnable || !IsUObjectValid(Object))
         return false;
@@ -374,17 +457,16 @@ bool FLuaContext::TryToBindLua(UObject* Object)
         return false;
     }
 
-    if (!IsInGameThread() || IsAsyncLoading())
+    if (!bFromBindBatch && (!IsInGameThread() || (IsAsyncLoading() && IsLoadingObject(Object))))
     {
-        // all bind operation should be in game thread, include dynamic bind
-        FScopeLock Lock(&Async2MainCS);
-        Candidates.AddUnique(Object);
+        // all bind operation should be in game thread, include dynamic bind. the objects spawned by gameplay during
+        // streaming are bound immediately, they don't wait behind the loaded ones
+        AsyncCandidates.Enqueue(FWeakObjectPtr(Object));
         return false;
     }
 
-    static UClass* InterfaceClass = UUnLuaInterface::StaticClass();
-
-    if (!Class->ImplementsInterface(InterfaceClass))
+    const FClassBindInfo& BindInfo = GetClassBindInfo(Class);
+    if (!BindInfo.bImplementsInterface)
     {
         // dynamic binding
         if (!GLuaDynamicBinding.IsValid(Class))
@@ -393,6 +475,9 @@ bool FLuaContext::TryToBindLua(UObject* Object)
         return Manager->Bind(Object, Class, *GLuaDynamicBinding.ModuleName, GLuaDynamicBinding.InitializerTableRef);
     }
 
+    if (BindInfo.ModuleName.IsEmpty())
+        return false;
+
     // filter some object in bp nest case
     // RF_WasLoaded & RF_NeedPostLoad?
     UObject* Outer = Object->GetOuter();
@@ -403,20 +488,50 @@ bool FLuaContext::TryToBindLua(UObject* Object)
         return false;
     }
 
-    if (GWorld)
+    if (IsInWidgetArchetype(Object))
     {
-        FString ObjectName;
-        Object->GetFullName(GWorld, ObjectName);
-        if (ObjectName.Contains(".WidgetArchetype:") || ObjectName.Contains(":WidgetTree."))
-        {
-            UE_LOG(LogUnLua, Warning, TEXT("Filter UObject of %s in WidgetArchetype"), *ObjectName);
-            return false;
-        }
+        UE_LOG(LogUnLua, Warning, TEXT("Filter UObject of %s in WidgetArchetype"), *Object->GetFullName(GWorld));
+        return false;
+    }
+
+    const FString ModuleName = BindInfo.ModuleName;     // copy, binding may create objects and grow the cache
+
+#if !UE_BUILD_SHIPPING
+    if (GLuaDynamicBinding.IsValid(Class) && GLuaDynamicBinding.ModuleName != ModuleName)
+    {
+        UE_LOG(LogUnLua, Warning, TEXT("Dynamic binding '%s' ignored as it conflicts static binding '%s'."), *GLuaDynamicBinding.ModuleName, *ModuleName);
+    }
+#endif
+
+    return Manager->Bind(Object, Class, *ModuleName, GLuaDynamicBinding.InitializerTableRef);
+}
+
+/**
+ * Get binding decisions of a UClass, they are computed once per class
+ */
+const FLuaContext::FClassBindInfo& FLuaContext::GetClassBindInfo(UClass* Class)
+{
+    FClassBindInfo* BindInfo = ClassBindInfos.Find(Class);
+    if (BindInfo && BindInfo->Class.Get() == Class)
+    {
+        return *BindInfo;
+    }
+
+    static UClass* InterfaceClass = UUnLuaInterface::StaticClass();
+
+    BindInfo = &ClassBindInfos.Add(Class);
+    BindInfo->Class = Class;
+    BindInfo->bImplementsInterface = Class->ImplementsInterface(InterfaceClass);
+    if (!BindInfo->bImplementsInterface)
+    {
+        return *BindInfo;
     }
 
     UFunction* Func = Class->FindFunctionByName(FName("GetModuleName")); // find UFunction 'GetModuleName'. hard coded!!!
     if (!Func)
-        return false;
+    {
+        return *BindInfo;
+    }
 
     // native func may not be bind in level bp
     if (!Func->GetNativeFunc())
@@ -424,25 +539,50 @@ bool FLuaContext::TryToBindLua(UObject* Object)
         Func->Bind();
         if (!Func->GetNativeFunc())
         {
-            UE_LOG(LogUnLua, Warning, TEXT("TryToBindLua: bind native function failed for GetModuleName in object %s"), *Object->GetName());
-            return false;
+            UE_LOG(LogUnLua, Warning, TEXT("TryToBindLua: bind native function failed for GetModuleName in class %s"), *Class->GetName());
+            return *BindInfo;
         }
     }
 
-    FString ModuleName;
     UObject* CDO = Class->GetDefaultObject();
-    CDO->ProcessEvent(Func, &ModuleName);
-    if (ModuleName.IsEmpty())
-        return false;
+    CDO->ProcessEvent(Func, &BindInfo->ModuleName);
+    return *BindInfo;
+}
 
-#if !UE_BUILD_SHIPPING
-    if (GLuaDynamicBinding.IsValid(Class) && GLuaDynamicBinding.ModuleName != ModuleName)
+/**
+ * Check if a UObject lives in a widget archetype, same as searching ".WidgetArchetype:" or ":WidgetTree." in its full name relative to GWorld
+ * but without building the name
+ */
+bool FLuaContext::IsInWidgetArchetype(UObject* Object)
+{
+    static const FName WidgetArchetypeName("WidgetArchetype");
+    static const FName WidgetTreeName("WidgetTree");
+
+    if (!GWorld)
     {
-        UE_LOG(LogUnLua, Warning, TEXT("Dynamic binding '%s' ignored as it conflicts static binding '%s'."), *GLuaDynamicBinding.ModuleName, *ModuleName);
+        return false;
     }
-#endif
 
-    return Manager->Bind(Object, Class, *ModuleName, GLuaDynamicBinding.InitializerTableRef);
+    for (UObject* Outer = Object->GetOuter(); Outer && Outer != GWorld; Outer = Outer->GetOuter())
+    {
+        UObject* OuterOuter = Outer->GetOuter();
+        if (!OuterOuter)
+        {
+            break;
+        }
+
+        // top level 'WidgetArchetype' in a package, or 'WidgetTree' right under a top level object
+        const FName OuterName = Outer->GetFName();
+        if (OuterName == WidgetArchetypeName && OuterOuter->IsA<UPackage>())
+        {
+            return true;
+        }
+        if (OuterName == WidgetTreeName && OuterOuter != GWorld && !OuterOuter->IsA<UPackage>() && OuterOuter->GetOuter() && OuterOuter->GetOuter()->IsA<UPackage>())
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 void FLuaContext::AddSearcher(int (*Searcher)(lua_State *), int Index)
@@ -499,6 +639,42 @@ void FLuaContext::OnWorldTickStart(ELevelTick TickType, float DeltaTime)
     FWorldDelegates::OnWorldTickStart.Remove(OnWorldTickStartHandle);
 }
 
+/**
+ * Persistent callback for FWorldDelegates::OnWorldTickStart, several worlds may tick in a frame (editor, PIE)
+ */
+#if ENGINE_MAJOR_VERSION > 4 || (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION > 23)
+void FLuaContext::OnWorldTick(UWorld* World, ELevelTick TickType, float DeltaTime)
+#else
+void FLuaContext::OnWorldTick(ELevelTick TickType, float DeltaTime)
+#endif
+{
+    if (LastTickFrame == GFrameCounter)
+    {
+        return;
+    }
+    LastTickFrame = GFrameCounter;
+    Tick(DeltaTime);
+}
+
+/**
+ * Per frame work of the Lua context
+ */
+void FLuaContext::Tick(float DeltaTime)
+{
+    if (!bEnable || !L)
+    {
+        return;
+    }
+
+    ProcessBindBatch(true);                                     // bind the async loaded objects left by the last flushes
+
+    CoroutineScheduler.Tick(DeltaTime);                         // resume coroutines waiting for a frame or time
+
+    GCController.Tick(DeltaTime);                               // step lua gc, after the coroutines made their garbage
+
+    GObjectReferencer.FlushPendingReleases();                   // release the objects of the userdata collected by lua gc
+}
+
 /**
  * Callback for FWorldDelegates::OnWorldCleanup
  */
@@ -551,43 +727,101 @@ void FLuaContext::OnPreExit()
  */
 void FLuaContext::OnAsyncLoadingFlushUpdate()
 {
-    if (!Manager)
+    ProcessBindBatch(false);                        // the frame is blocked by the flush, e.g. a map is loaded synchronously
+}
+
+/**
+ * Bind Lua modules for the objects created during async loading
+ *
+ * @param bBudgeted - whether to stop when the per frame budget is used up, the rest are left to the next tick
+ */
+void FLuaContext::ProcessBindBatch(bool bBudgeted)
+{
+    if (!Manager || !IsInGameThread())
         return;
 
-    TArray<UObject*> LocalCandidates;
+    SCOPE_CYCLE_COUNTER(STAT_UnLua_BindBatch);
+
+    FWeakObjectPtr ObjectPtr;
+    while (AsyncCandidates.Dequeue(ObjectPtr))
     {
-        FScopeLock Lock(&Async2MainCS);
+        bool bAlreadyInSet = false;
+        CandidateSet.Add(ObjectPtr, &bAlreadyInSet);
+        if (!bAlreadyInSet)
+        {
+            Candidates.Add(ObjectPtr);
+        }
+    }
+
+    const double Budget = UNLUA_BIND_BATCH_BUDGET_MS / 1000.0;
+    bBudgeted = bBudgeted && Budget > 0.0;
+    const int32 MaxObjects = bBudgeted ? UNLUA_BIND_BATCH_MAX_OBJECTS : MAX_int32;
 
-        static constexpr EInternalObjectFlags AsyncObjectFlags = EInternalObjectFlags::AsyncLoading | EInternalObjectFlags::Async;
-        for (int32 i = Candidates.Num() - 1; i >= 0; --i)
+    // collect the ready candidates before binding them, binding runs Lua code which may flush async loading and get here again.
+    // every candidate is visited once at most, the ones not ready yet are moved to the tail
+    TArray<FWeakObjectPtr> ReadyObjects;
+    for (int32 NumToVisit = Candidates.Num() - CandidatesHead; NumToVisit > 0 && ReadyObjects.Num() < MaxObjects; --NumToVisit)
+    {
+        ObjectPtr = Candidates[CandidatesHead++];
+        UObject* Object = ObjectPtr.Get();
+        if (!Object)
         {
-            FWeakObjectPtr ObjectPtr = Candidates[i];
-            if (!ObjectPtr.IsValid())
-            {
-                // discard invalid objects
-                Candidates.RemoveAt(i);
-                continue;
-            }
+            // discard invalid objects
+            CandidateSet.Remove(ObjectPtr);
+            continue;
+        }
 
-            UObject* Object = ObjectPtr.Get();
-            if (Object->HasAnyFlags(RF_NeedPostLoad)
-                || Object->HasAnyInternalFlags(AsyncObjectFlags)
-                || Object->GetClass()->HasAnyInternalFlags(AsyncObjectFlags))
-            {
-                // delay bind on next update 
-                continue;
-            }
-            
-            LocalCandidates.Add(Object);
-            Candidates.RemoveAt(i);
+        if (Object->HasAnyFlags(RF_NeedPostLoad)
+            || Object->HasAnyInternalFlags(AsyncObjectFlags)
+            || Object->GetClass()->HasAnyInternalFlags(AsyncObjectFlags))
+        {
+            // delay bind on next update
+            Candidates.Add(ObjectPtr);
+            continue;
         }
+
+        CandidateSet.Remove(ObjectPtr);
+        ReadyObjects.Add(ObjectPtr);
+    }
+
+    // drop the consumed head, the candidates are never shifted one by one
+    if (CandidatesHead == Candidates.Num())
+    {
+        Candidates.Reset();
+        CandidatesHead = 0;
+    }
+    else if (CandidatesHead > 1024 && CandidatesHead > Candidates.Num() / 2)
+    {
+        Candidates.RemoveAt(0, CandidatesHead, false);
+        CandidatesHead = 0;
     }
 
-    for (int32 i = 0; i < LocalCandidates.Num(); ++i)
+    const double StartTime = FPlatformTime::Seconds();
+    for (int32 i = 0; i < ReadyObjects.Num(); ++i)
     {
-        UObject* Object = LocalCandidates[i];
-        TryToBindLua(Object);
+        if (bBudgeted && i > 0 && FPlatformTime::Seconds() - StartTime >= Budget)
+        {
+            // out of time, the rest are left to the next tick
+            for (; i < ReadyObjects.Num(); ++i)
+            {
+                bool bAlreadyInSet = false;
+                CandidateSet.Add(ReadyObjects[i], &bAlreadyInSet);
+                if (!bAlreadyInSet)
+                {
+                    Candidates.Add(ReadyObjects[i]);
+                }
+            }
+            break;
+        }
+
+        UObject* Object = ReadyObjects[i].Get();
+        if (Object)
+        {
+            TryToBindLua(Object, true);
+        }
     }
+
+    SET_DWORD_STAT(STAT_UnLua_BindCandidates, Candidates.Num() - CandidatesHead);
 }
 
 /**
@@ -623,6 +857,8 @@ void FLuaContext::PostLoadMapWithWorld(UWorld* World)
         return;
     }
 
+    ProcessBindBatch(false);                        // bind all the objects of the loaded map
+
 #if !WITH_EDITOR
 
     // !!!Fix!!!
@@ -692,69 +928,18 @@ void FLuaContext::PrePIEEnded(bool bIsSimulating)
 
 #endif
 
-/**
- * Add a Lua coroutine and its reference in Lua registry
- */
-void FLuaContext::AddThread(lua_State* Thread, int32 ThreadRef)
-{
-    ThreadToRef.Add(Thread, ThreadRef);
-    RefToThread.Add(ThreadRef, Thread);
-}
-
-/**
- * Starts and resumes a Lua coroutine
- */
-void FLuaContext::ResumeThread(int32 ThreadRef)
-{
-    lua_State** ThreadPtr = RefToThread.Find(ThreadRef);
-    if (ThreadPtr)
-    {
-        lua_State* Thread = *ThreadPtr;
-#if 504 == LUA_VERSION_NUM
-        int NResults = 0;
-        int32 State = lua_resume(Thread, L, 0, &NResults);
-#else
-        int32 State = lua_resume(Thread, L, 0);
-#endif
-        if (State == LUA_OK)
-        {
-            ThreadToRef.Remove(Thread);
-            RefToThread.Remove(ThreadRef);
-            luaL_unref(L, LUA_REGISTRYINDEX, ThreadRef);    // remove the reference if the coroutine finishes its execution
-        }
-    }
-}
-
-/**
- * Clean up all Lua coroutines
- */
-void FLuaContext::CleanupThreads()
-{
-    ThreadToRef.Empty();
-    RefToThread.Empty();
-}
-
-/**
- * Find a Lua coroutine
- */
-int32 FLuaContext::FindThread(lua_State* Thread)
-{
-    int32* ThreadRefPtr = ThreadToRef.Find(Thread);
-    return ThreadRefPtr ? *ThreadRefPtr : LUA_REFNIL;
-}
-
 /**
  * Callback when a UObjectBase (not full UObject) is created
  */
 void FLuaContext::NotifyUObjectCreated(const UObjectBase* InObject, int32 Index)
 {
-    {
-        FScopeLock Lock(&Async2MainCS);
-        UObjPtr2Idx.Add(const_cast<UObjectBase*>(InObject), Index);
+    ObjectTable.Add(InObject, Index);
 #if UNLUA_ENABLE_DEBUG != 0
+    {
+        FScopeLock Lock(&DebugNameCS);
         UObjPtr2Name.Add(const_cast<UObjectBase*>(InObject), InObject->GetFName().ToString());
-#endif
     }
+#endif
 
     if (!bEnable)
     {
@@ -802,10 +987,10 @@ void FLuaContext::NotifyUObjectDeleted(const UObjectBase* InObject, int32 Index)
 {
     if (!bEnable)
     {
-        FScopeLock Lock(&Async2MainCS);
-        UObjPtr2Idx.Remove(InObject);
+        ObjectTable.Remove(InObject, Index);
 
 #if UNLUA_ENABLE_DEBUG != 0
+        FScopeLock Lock(&DebugNameCS);
         UObjPtr2Name.Remove(InObject);
 #endif
 
@@ -813,7 +998,11 @@ void FLuaContext::NotifyUObjectDeleted(const UObjectBase* InObject, int32 Index)
     }
 
 #if UNLUA_ENABLE_DEBUG != 0
-    UE_LOG(LogUnLua, Log, TEXT("NotifyUObjectDeleted : %s,%p"), *UObjPtr2Name[InObject], InObject);
+    {
+        FScopeLock Lock(&DebugNameCS);
+        const FString *Name = UObjPtr2Name.Find(InObject);
+        UE_LOG(LogUnLua, Log, TEXT("NotifyUObjectDeleted : %s,%p"), Name ? **Name : TEXT(""), InObject);
+    }
 #endif
 
     bool bClass = GReflectionRegistry.NotifyUObjectDeleted(InObject);
@@ -829,9 +1018,12 @@ void FLuaContext::NotifyUObjectDeleted(const UObjectBase* InObject, int32 Index)
         }
     }
 
-    FScopeLock Lock(&Async2MainCS);
-    UObjPtr2Idx.Remove(InObject);
+    ObjectTable.Remove(InObject, Index);
+
+#if UNLUA_ENABLE_DEBUG != 0
+    FScopeLock Lock(&DebugNameCS);
     UObjPtr2Name.Remove(InObject);
+#endif
 }
 
 
@@ -857,7 +1049,8 @@ void FLuaContext::OnUObjectArrayShutdown()
 #endif
 
 /**
- * Robust method to verify uobject
+ * Robust method to verify uobject. Doesn't lock, so it's safe to call from Lua on the game thread while
+ * the async loading thread is creating objects.
  */
 bool FLuaContext::IsUObjectValid(UObjectBase* UObjPtr)
 {
@@ -866,33 +1059,55 @@ bool FLuaContext::IsUObjectValid(UObjectBase* UObjPtr)
         return false;
     }
 
-    int32 UObjIdx = -1;
+    const int32 UObjIdx = ObjectTable.Find(UObjPtr);
+    if (UObjIdx == INDEX_NONE)
     {
-        FScopeLock Lock(&Async2MainCS);
-        if (UObjPtr2Idx.Contains(UObjPtr))
-        {
-            UObjIdx = UObjPtr2Idx[UObjPtr];
-        }
+        return false;
     }
 
-    if (-1 != UObjIdx)
+    FUObjectItem* UObjectItem = GUObjectArray.IndexToObject(UObjIdx);
+    return UObjectItem && ((UObjPtr->GetFlags() & (RF_BeginDestroyed | RF_FinishDestroyed)) == 0) && !UObjectItem->IsUnreachable();
+}
+
+/**
+ * Callback before garbage collection
+ */
+void FLuaContext::OnPreGarbageCollect()
+{
+    if (L)
     {
-        FUObjectItem* UObjectItem = GUObjectArray.IndexToObject(UObjIdx);
-        if (!UObjectItem)
-        {
-            return false;
-        }
-        else
+        GCController.FinishDrain();                             // the garbage of a cleaned up world must be collected first
+    }
+    GObjectReferencer.FlushPendingReleases();                   // let UE collect the objects released by lua gc
+}
+
+/**
+ * Callback after garbage collection
+ */
+void FLuaContext::OnPostGarbageCollect()
+{
+    // async loading is suspended during GC, nobody can be probing the retired tables now
+    ObjectTable.ReclaimRetiredTables();
+
+    if (L)
+    {
+        GCController.OnPostEngineGC();
+    }
+
+    for (TMap<UClass*, FClassBindInfo>::TIterator It(ClassBindInfos); It; ++It)
+    {
+        if (!It.Value().Class.IsValid())
         {
-            return (UObjPtr == UObjectItem->Object) && ((UObjPtr->GetFlags() & (RF_BeginDestroyed | RF_FinishDestroyed)) == 0)
-                    && !UObjectItem->IsUnreachable();
+            It.RemoveCurrent();
         }
     }
-    else
+
+    for (TSet<TWeakObjectPtr<const UStruct>>::TIterator It(EagerRegistrationStructs); It; ++It)
     {
-        //!!!Fix!!!
-        //all should be false here?
-        return false;
+        if (!It->IsValid())
+        {
+            It.RemoveCurrent();
+        }
     }
 }
 
@@ -903,7 +1118,7 @@ UUnLuaManager* FLuaContext::GetUnLuaManager()
 
 
 FLuaContext::FLuaContext()
-    : L(nullptr), Manager(nullptr), bEnable(false)
+    : L(nullptr), Manager(nullptr), CandidatesHead(0), NumFieldSlowPathHits(0), NumPushUObjectHits(0), NumPushUObjectMisses(0), LastTickFrame(0), bEnable(false)
 {
 #if WITH_EDITOR
     LuaHandle = nullptr;
@@ -931,59 +1146,14 @@ FLuaContext::~FLuaContext()
     GUObjectArray.RemoveUObjectDeleteListener(GLuaCxt);
 #endif
 
-    FScopeLock Lock(&Async2MainCS);
-    UObjPtr2Idx.Empty();
+    ObjectTable.Empty();
 
 #if UNLUA_ENABLE_DEBUG != 0
+    FScopeLock Lock(&DebugNameCS);
     UObjPtr2Name.Empty();
 #endif
 }
 
-/**
- * Allocator for Lua VM
- */
-void* FLuaContext::LuaAllocator(void* ud, void* ptr, size_t osize, size_t nsize)
-{
-    if (nsize == 0)
-    {
-#if STATS
-        const uint32 Size = FMemory::GetAllocSize(ptr);
-        DEC_MEMORY_STAT_BY(STAT_UnLua_Lua_Memory, Size);
-#endif
-        FMemory::Free(ptr);
-        return nullptr;
-    }
-
-    void* Buffer;
-    if (!ptr)
-    {
-        Buffer = FMemory::Malloc(nsize);
-#if STATS
-        const uint32 Size = FMemory::GetAllocSize(Buffer);
-        INC_MEMORY_STAT_BY(STAT_UnLua_Lua_Memory, Size);
-#endif
-    }
-    else
-    {
-#if STATS
-        const uint32 OldSize = FMemory::GetAllocSize(ptr);
-#endif
-        Buffer = FMemory::Realloc(ptr, nsize);
-#if STATS
-        const uint32 NewSize = FMemory::GetAllocSize(Buffer);
-        if (NewSize > OldSize)
-        {
-            INC_MEMORY_STAT_BY(STAT_UnLua_Lua_Memory, NewSize - OldSize);
-        }
-        else
-        {
-            DEC_MEMORY_STAT_BY(STAT_UnLua_Lua_Memory, OldSize - NewSize);
-        }
-#endif
-    }
-    return Buffer;
-}
-
 /**
  * Initialize UnLua
  */
@@ -991,7 +1161,11 @@ void FLuaContext::Initialize()
 {
     if (!bEnable)
     {
+#if UNLUA_USE_SMALL_OBJECT_POOL
+        CreateState(UnLua::ELuaAllocator::SmallObjectPool);    // create Lua main thread
+#else
         CreateState();  // create Lua main thread
+#endif
 
         // create UnLuaManager and add it to root
         Manager = NewObject<UUnLuaManager>();
@@ -1001,6 +1175,15 @@ void FLuaContext::Initialize()
         {
             GPropertyCreator.Cleanup();
             bEnable = true;
+
+#if WITH_EDITOR
+            if (GEditor && !OnBlueprintCompiledHandle.IsValid())
+            {
+                // 'GetModuleName' may return something else after recompiling
+                OnBlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddLambda([this]() { ClassBindInfos.Empty(); });
+            }
+#endif
+
             FUnLuaDelegates::OnLuaContextInitialized.Broadcast();
         }
     }
@@ -1022,9 +1205,12 @@ void FLuaContext::Cleanup(bool bFullCleanup, UWorld* World)
 
         if (!bFullCleanup)
         {
-            // force full lua gc
-            lua_gc(L, LUA_GCCOLLECT, 0);
-            lua_gc(L, LUA_GCCOLLECT, 0);
+            // collect the garbage of the world over the next frames, or force full lua gc if nobody steps lua gc
+            if (!GCController.RequestDrain())
+            {
+                lua_gc(L, LUA_GCCOLLECT, 0);
+                lua_gc(L, LUA_GCCOLLECT, 0);
+            }
 
             //!!!Fix!!!
             // do some check work here
@@ -1036,15 +1222,16 @@ void FLuaContext::Cleanup(bool bFullCleanup, UWorld* World)
             // close lua state first
             lua_close(L);
             L = nullptr;
+            LuaPool.Empty();                                    // all blocks have been released by 'lua_close'
 
             // clean ue side modules,es static data structs
             FCollisionHelper::Cleanup();                        // clean up collision helper stuff
 
             GObjectReferencer.Cleanup();                        // clean up object referencer
 
-            //!!!Fix!!!
-            //thread need refine
-            CleanupThreads();                                   // lua thread
+            CoroutineScheduler.Cleanup();                       // lua thread
+
+            GCController.Cleanup();
 
             LibraryNames.Empty();                               // metatables and lua module
             ModuleNames.Empty();
@@ -1055,13 +1242,27 @@ void FLuaContext::Cleanup(bool bFullCleanup, UWorld* World)
 
             GPropertyCreator.Cleanup();                             // clean up dynamically created UProperties
 
+            ParamBufferArena.Cleanup();                             // free parameter buffers
+
             GReflectionRegistry.Cleanup();                      // clean up reflection registry
 
             GameInstances.Empty();
             CandidateInputComponents.Empty();
-            FCoreUObjectDelegates::GetPostGarbageCollect().Remove(OnPostGarbageCollectHandle);
+            AsyncCandidates.Empty();
+            Candidates.Empty();
+            CandidateSet.Empty();
+            CandidatesHead = 0;
+            ClassBindInfos.Empty();
             FWorldDelegates::OnWorldTickStart.Remove(OnWorldTickStartHandle);
 
+#if WITH_EDITOR
+            if (GEditor)
+            {
+                GEditor->OnBlueprintCompiled().Remove(OnBlueprintCompiledHandle);
+            }
+            OnBlueprintCompiledHandle.Reset();
+#endif
+
             // old manager
             if (Manager)
             {
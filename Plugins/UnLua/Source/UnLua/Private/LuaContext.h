@@ -15,10 +15,24 @@
 #pragma once
 
 #include "UObject/UObjectArray.h"
+#include "Containers/Queue.h"
 #include "Engine/World.h"
 #include "GenericPlatform/GenericApplication.h"
 #include "Runtime/Launch/Resources/Version.h"
 #include "UnLuaBase.h"
+#include "ObjectValidityTable.h"
+#include "LuaAllocator.h"
+#include "ReflectionUtils/ParamBufferArena.h"
+#include "LuaCoroutineScheduler.h"
+#include "LuaGCController.h"
+
+#ifndef UNLUA_BIND_BATCH_BUDGET_MS
+#define UNLUA_BIND_BATCH_BUDGET_MS 2.0f             // time budget per tick of binding the objects created during async loading, 0 or less binds them all at once
+#endif
+
+#ifndef UNLUA_BIND_BATCH_MAX_OBJECTS
+#define UNLUA_BIND_BATCH_MAX_OBJECTS 512            // max number of the objects created during async loading bound per tick, flushes and map loads bind them all
+#endif
 
 class FLuaContext : public FUObjectArray::FUObjectCreateListener, public FUObjectArray::FUObjectDeleteListener
 {
@@ -27,7 +41,7 @@ public:
 
     void RegisterDelegates();
 
-    void CreateState();
+    void CreateState(UnLua::ELuaAllocator Allocator = UnLua::ELuaAllocator::Default);
     void SetEnable(bool InEnable);
     bool IsEnable() const;
 
@@ -41,7 +55,20 @@ public:
     bool AddTypeInterface(FName Name, TSharedPtr<UnLua::ITypeInterface> TypeInterface);
     TSharedPtr<UnLua::ITypeInterface> FindTypeInterface(FName Name);
 
-    bool TryToBindLua(UObject *Object);
+    UNLUA_API bool TryToBindLua(UObject *Object, bool bFromBindBatch = false);
+    UNLUA_API void ProcessBindBatch(bool bBudgeted);
+    FORCEINLINE int32 GetNumBindCandidates() const { return Candidates.Num() - CandidatesHead; }
+
+    void SetEagerClassRegistration(const UStruct *Struct, bool bEager);
+    bool IsEagerClassRegistration(const UStruct *Struct) const;
+
+    FORCEINLINE void IncNumFieldSlowPathHits() { ++NumFieldSlowPathHits; }
+    FORCEINLINE uint32 GetNumFieldSlowPathHits() const { return NumFieldSlowPathHits; }
+
+    FORCEINLINE void IncNumPushUObjectHits() { ++NumPushUObjectHits; }
+    FORCEINLINE void IncNumPushUObjectMisses() { ++NumPushUObjectMisses; }
+    FORCEINLINE uint32 GetNumPushUObjectHits() const { return NumPushUObjectHits; }
+    FORCEINLINE uint32 GetNumPushUObjectMisses() const { return NumPushUObjectMisses; }
 
     void AddLibraryName(const TCHAR *LibraryName) { LibraryNames.Add(LibraryName); }
     void AddModuleName(const TCHAR *ModuleName) { ModuleNames.AddUnique(ModuleName); }
@@ -53,11 +80,18 @@ public:
 #else
     void OnWorldTickStart(ELevelTick TickType, float DeltaTime);
 #endif
+#if ENGINE_MAJOR_VERSION > 4 || (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION > 23)
+    void OnWorldTick(UWorld *World, ELevelTick TickType, float DeltaTime);
+#else
+    void OnWorldTick(ELevelTick TickType, float DeltaTime);
+#endif
+    void Tick(float DeltaTime);
     void OnWorldCleanup(UWorld *World, bool bSessionEnded, bool bCleanupResources);
     void OnPostEngineInit();
     void OnPreExit();
     void OnCrash();
     void PostLoadMapWithWorld(UWorld *World);
+    void OnPreGarbageCollect();
     void OnPostGarbageCollect();
 
 #if WITH_EDITOR
@@ -72,13 +106,13 @@ public:
     const TArray<UnLua::IExportedFunction*>& GetExportedFunctions() const { return ExportedFunctions; }
     const TMap<const TCHAR *, int (*)(lua_State *)>& GetBuiltinLoaders() const { return BuiltinLoaders; } 
 
-    void AddThread(lua_State *Thread, int32 ThreadRef);
-    void ResumeThread(int32 ThreadRef);
-    void CleanupThreads();
-    int32 FindThread(lua_State *Thread);
+    FORCEINLINE FLuaCoroutineScheduler& GetCoroutineScheduler() { return CoroutineScheduler; }
+    FORCEINLINE FLuaGCController& GetGCController() { return GCController; }
 
     FORCEINLINE class UUnLuaManager* GetManager() const { return Manager; }
 
+    FORCEINLINE FParamBufferArena& GetParamBufferArena() { return ParamBufferArena; }
+
     FORCEINLINE operator lua_State*() const { return L; }
 
     // interfaces of FUObjectArray::FUObjectCreateListener and FUObjectArray::FUObjectDeleteListener
@@ -96,12 +130,19 @@ private:
     FLuaContext();
     ~FLuaContext();
 
-    // allocator used for 'lua_newstate'
-    static void* LuaAllocator(void *ud, void *ptr, size_t osize, size_t nsize);
-
     void Initialize();
     void Cleanup(bool bFullCleanup = false, UWorld *World = nullptr);
 
+    struct FClassBindInfo
+    {
+        FWeakObjectPtr Class;               // detects a deleted class whose address is reused
+        FString ModuleName;                 // empty if the class can't be statically bound
+        bool bImplementsInterface;
+    };
+
+    const FClassBindInfo& GetClassBindInfo(UClass *Class);
+    static bool IsInWidgetArchetype(UObject *Object);
+
     void OnAsyncLoadingFlushUpdate();
     bool OnGameViewportInputKey(FKey InKey, FModifierKeysState ModifierKeyState, EInputEvent EventType);
 
@@ -112,11 +153,24 @@ private:
     FDelegateHandle OnActorSpawnedHandle;
     FDelegateHandle OnWorldTickStartHandle;
     FDelegateHandle OnPostGarbageCollectHandle;
+#if WITH_EDITOR
+    FDelegateHandle OnBlueprintCompiledHandle;
+#endif
 
     TArray<FString> LibraryNames;       // metatables for classes/enums
     TArray<FString> ModuleNames;        // required Lua modules
 
-    TArray<FWeakObjectPtr> Candidates;        // binding candidates during async loading
+    TQueue<FWeakObjectPtr, EQueueMode::Mpsc> AsyncCandidates;          // binding candidates during async loading, lock free for the producers
+    TArray<FWeakObjectPtr> Candidates;                                  // binding candidates drained on game thread, consumed from 'CandidatesHead'
+    TSet<FWeakObjectPtr> CandidateSet;                                  // filters out the candidates pushed more than once
+    int32 CandidatesHead;
+
+    TMap<UClass*, FClassBindInfo> ClassBindInfos;   // cached binding decisions per class, game thread only
+
+    TSet<TWeakObjectPtr<const UStruct>> EagerRegistrationStructs;     // classes whose metatables are populated at registration, inherited by subclasses
+    uint32 NumFieldSlowPathHits;                    // field lookups that missed the metatable and went through reflection
+    uint32 NumPushUObjectHits;                      // UObjects pushed from 'ObjectMap'
+    uint32 NumPushUObjectMisses;                    // UObjects pushed with a new userdata
 
     TArray<UnLua::IExportedFunction*> ExportedFunctions;                // statically exported global functions
     TArray<UnLua::IExportedEnum*> ExportedEnums;                        // statically exported enums
@@ -127,13 +181,16 @@ private:
 
     TMap<const TCHAR *, int (*)(lua_State *)> BuiltinLoaders;
 
-    //!!!Fix!!!
-    //thread need refine
-    TMap<lua_State*, int32> ThreadToRef;                                // coroutine -> ref
-    TMap<int32, lua_State*> RefToThread;                                // ref -> coroutine
-	TMap<UObjectBase *, int32> UObjPtr2Idx;                             // UObject pointer -> index in GUObjectArray
+    FLuaCoroutineScheduler CoroutineScheduler;                          // coroutines resumed from C++
+    FLuaGCController GCController;                                      // per frame Lua GC steps
+    FParamBufferArena ParamBufferArena;                                 // parameter buffers of nested/reentrant UFunction calls
+    FLuaSmallObjectPool LuaPool;                                        // only used by UnLua::ELuaAllocator::SmallObjectPool
+
+    FObjectValidityTable ObjectTable;                                   // live UObjects, lock free for readers
+#if UNLUA_ENABLE_DEBUG != 0
     TMap<UObjectBase*, FString> UObjPtr2Name;                           // UObject pointer -> Name for debug purpose
-    FCriticalSection Async2MainCS;                                      // async loading thread and main thread sync lock
+    FCriticalSection DebugNameCS;
+#endif
 
 #if WITH_EDITOR
     void *LuaHandle;
@@ -142,7 +199,9 @@ private:
     TArray<class UInputComponent*> CandidateInputComponents;
     TArray<UGameInstance*> GameInstances;
 
+    uint64 LastTickFrame;                                               // GFrameCounter of the last FLuaContext::Tick
+
     bool bEnable;
 };
 
-extern class FLuaContext *GLuaCxt;
+extern UNLUA_API class FLuaContext *GLuaCxt;
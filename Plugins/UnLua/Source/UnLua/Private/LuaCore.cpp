@@ -26,6 +26,7 @@
 #include "ReflectionUtils/PropertyCreator.h"
 #include "ReflectionUtils/PropertyDesc.h"
 #include "ReflectionUtils/ReflectionRegistry.h"
+#include "LuaScriptArchive.h"
 #include "Kismet/KismetSystemLibrary.h"
 
 extern "C"
@@ -65,11 +66,10 @@ static int32 UE4_Index(lua_State *L)
 }
 
 /**
- * Get lua file full path from relative path
+ * Get the full path of a lua file downloaded to 'ProjectPersistentDownloadDir', empty if there is no such file
  */
-FString GetFullPathFromRelativePath(const FString& RelativePath)
+FString GetDownloadedFilePath(const FString& RelativePath)
 {
-    FString FullFilePath = GLuaSrcFullPath + RelativePath;
     FString ProjectDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir());
     FString ProjectPersistentDownloadDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectPersistentDownloadDir());
     if (!ProjectPersistentDownloadDir.EndsWith("/"))
@@ -77,13 +77,23 @@ FString GetFullPathFromRelativePath(const FString& RelativePath)
         ProjectPersistentDownloadDir.Append("/");
     }
 
-    FString RealFullFilePath = FullFilePath.Replace(*ProjectDir, *ProjectPersistentDownloadDir);        // try to load the file from 'ProjectPersistentDownloadDir' first
-    if (IFileManager::Get().FileExists(*RealFullFilePath))
+    FString DownloadedFilePath = (GLuaSrcFullPath + RelativePath).Replace(*ProjectDir, *ProjectPersistentDownloadDir);
+    if (!IFileManager::Get().FileExists(*DownloadedFilePath))
     {
-        FullFilePath = RealFullFilePath;
+        DownloadedFilePath.Empty();
     }
-    else
+    return DownloadedFilePath;
+}
+
+/**
+ * Get lua file full path from relative path
+ */
+FString GetFullPathFromRelativePath(const FString& RelativePath)
+{
+    FString FullFilePath = GetDownloadedFilePath(RelativePath);        // try to load the file from 'ProjectPersistentDownloadDir' first
+    if (FullFilePath.IsEmpty())
     {
+        FullFilePath = GLuaSrcFullPath + RelativePath;
         if (!IFileManager::Get().FileExists(*FullFilePath))
         {
             FullFilePath = "";
@@ -102,6 +112,12 @@ void CreateNamespaceForUE(lua_State *L)
     lua_pushstring(L, "__index");
     lua_pushcfunction(L, UE4_Index);
     lua_rawset(L, -3);
+    lua_pushstring(L, "GetProperties");
+    lua_pushcfunction(L, Global_GetProperties);
+    lua_rawset(L, -3);
+    lua_pushstring(L, "SetProperties");
+    lua_pushcfunction(L, Global_SetProperties);
+    lua_rawset(L, -3);
     lua_pushvalue(L, -1);
     lua_setmetatable(L, -2);
     lua_pushvalue(L, -1);
@@ -110,6 +126,9 @@ void CreateNamespaceForUE(lua_State *L)
 
     lua_pushboolean(L, true);
 #else
+    lua_register(L, "GetProperties", Global_GetProperties);
+    lua_register(L, "SetProperties", Global_SetProperties);
+
     lua_pushboolean(L, false);
 #endif
     lua_setglobal(L, "WITH_UE4_NAMESPACE");
@@ -135,6 +154,7 @@ void SetTableForClass(lua_State *L, const char *Name)
 #define BIT_VARIANT_TAG            (1 << 7)         // variant tag for userdata
 #define BIT_TWOLEVEL_PTR        (1 << 5)            // two level pointer flag
 #define BIT_SCRIPT_CONTAINER    (1 << 4)            // script container (TArray, TSet, TMap) flag
+#define BIT_OBJECT_REF          (1 << 3)            // the userdata holds a strong reference of its UObject
 
 #pragma  pack(push)
 #pragma  pack(1)
@@ -339,6 +359,40 @@ void MarkUserdataTwoLvPtrTag(void* Userdata)
     }
 }
 
+/**
+ * Add a strong reference of the UObject for the userdata on the top of the stack, it's released when the userdata is collected
+ */
+void AddUserdataObjectRef(lua_State *L, UObjectBaseUtility *Object)
+{
+    TValue* Value = GetTValue(L, -1);
+    if (GetTValueType(Value) != LUA_TUSERDATA)
+    {
+        return;                                                     // nil, the object can't be pushed
+    }
+
+    FUserdataDesc* UserdataDesc = GetUserdataDesc(GetUdata(Value));
+    if (UserdataDesc && !(UserdataDesc->tag & BIT_OBJECT_REF))
+    {
+        UserdataDesc->tag |= BIT_OBJECT_REF;
+        GObjectReferencer.AddObjectRef((UObject*)Object);
+    }
+}
+
+/**
+ * Test whether the userdata at the given stack index holds a strong reference of its UObject
+ */
+bool HasUserdataObjectRef(lua_State *L, int32 Index)
+{
+    TValue* Value = GetTValue(L, Index);
+    if (GetTValueType(Value) != LUA_TUSERDATA)
+    {
+        return false;
+    }
+
+    FUserdataDesc* UserdataDesc = GetUserdataDesc(GetUdata(Value));
+    return UserdataDesc && (UserdataDesc->tag & BIT_OBJECT_REF);
+}
+
 
 /**
  * Get the address of userdata
@@ -487,6 +541,22 @@ bool TryToSetMetatable(lua_State* L, const char* MetatableName, UObject* Object)
     }
 }
 
+/**
+ * Set the metatable of a reflected class for the userdata on the top of the stack, without looking it up by name
+ */
+bool TryToSetMetatable(lua_State *L, FClassDesc *ClassDesc)
+{
+    const int32 MetatableRef = ClassDesc->GetMetatableRef();
+    if (MetatableRef == LUA_NOREF)
+    {
+        return TryToSetMetatable(L, TCHAR_TO_UTF8(*ClassDesc->GetName()));     // the class isn't registered to Lua yet
+    }
+
+    lua_rawgeti(L, LUA_REGISTRYINDEX, MetatableRef);
+    lua_setmetatable(L, -2);
+    ClassDesc->AddRef();
+    return true;
+}
 
 FString GetMetatableName(const UObjectBaseUtility* Object)
 {   
@@ -614,7 +684,7 @@ void* CacheScriptContainer(lua_State *L, void *Key, const FScriptContainerDesc &
 
     // return null if container is already cached, or create/cache/return a new ud
     void *Userdata = nullptr;
-    lua_getfield(L, LUA_REGISTRYINDEX, "ScriptContainerMap");
+    PushRegistryTable(L, ERegistryTable::ScriptContainerMap);
     lua_pushlightuserdata(L, Key);
     int32 Type = lua_rawget(L, -2);             
     if (Type == LUA_TNIL)
@@ -667,7 +737,7 @@ void RemoveCachedScriptContainer(lua_State *L, void *Key)
         return;
     }
 
-    lua_getfield(L, LUA_REGISTRYINDEX, "ScriptContainerMap");
+    PushRegistryTable(L, ERegistryTable::ScriptContainerMap);
     lua_pushlightuserdata(L, Key);
     int32 Type = lua_rawget(L, -2);
     if (Type != LUA_TNIL)
@@ -684,6 +754,18 @@ void RemoveCachedScriptContainer(lua_State *L, void *Key)
  */
 void PushObjectCore(lua_State *L, UObjectBaseUtility *Object)
 {
+    // fast path, instances of registered classes. classes and enums use their own metatables, see 'GetMetatableName'
+    if (GLuaCxt->IsUObjectValid((UObjectBase*)Object) && !Object->IsA<UField>())
+    {
+        FClassDesc *ClassDesc = GReflectionRegistry.FindClass(Object->GetClass());
+        if (ClassDesc && ClassDesc->GetMetatableRef() != LUA_NOREF)
+        {
+            NewUserdataWithTwoLvPtrTag(L, sizeof(void*), Object);  // create a userdata and store the UObject address
+            TryToSetMetatable(L, ClassDesc);
+            return;
+        }
+    }
+
     FString MetatableName = GetMetatableName(Object);
     if (MetatableName.IsEmpty())
     {
@@ -733,7 +815,7 @@ static void PushEnumElement(lua_State *L, FNumericProperty *Property, void *Valu
  */
 static void PushFNameElement(lua_State *L, FNameProperty *Property, void *Value)
 {
-    lua_pushstring(L, TCHAR_TO_UTF8(*Property->GetPropertyValue(Value).ToString()));
+    UnLua::PushFName(L, Property->GetPropertyValue(Value));
 }
 
 /**
@@ -741,7 +823,7 @@ static void PushFNameElement(lua_State *L, FNameProperty *Property, void *Value)
  */
 static void PushFStringElement(lua_State *L, FStrProperty *Property, void *Value)
 {
-    lua_pushstring(L, TCHAR_TO_UTF8(*Property->GetPropertyValue(Value)));
+    UnLua::PushFString(L, Property->GetPropertyValue(Value));
 }
 
 /**
@@ -749,7 +831,7 @@ static void PushFStringElement(lua_State *L, FStrProperty *Property, void *Value
  */
 static void PushFTextElement(lua_State *L, FTextProperty *Property, void *Value)
 {
-    lua_pushstring(L, TCHAR_TO_UTF8(*Property->GetPropertyValue(Value).ToString()));
+    UnLua::PushFString(L, Property->GetPropertyValue(Value).ToString());
 }
 
 /**
@@ -758,8 +840,8 @@ static void PushFTextElement(lua_State *L, FTextProperty *Property, void *Value)
 static void PushObjectElement(lua_State *L, FObjectPropertyBase *Property, void *Value)
 {
     UObject *Object = Property->GetObjectPropertyValue(Value);
-    GObjectReferencer.AddObjectRef(Object);
     PushObjectCore(L, Object);
+    AddUserdataObjectRef(L, Object);
 }
 
 /**
@@ -769,8 +851,8 @@ static void PushInterfaceElement(lua_State *L, FInterfaceProperty *Property, voi
 {
     const FScriptInterface &Interface = Property->GetPropertyValue(Value);
     UObject *Object = Interface.GetObject();
-    GObjectReferencer.AddObjectRef(Object);
     PushObjectCore(L, Object);
+    AddUserdataObjectRef(L, Object);
 }
 
 /**
@@ -853,7 +935,7 @@ static void PushPropertyArray(lua_State *L, T *Property, void *Value, void(*Push
         return;
     }
 
-    lua_getfield(L, LUA_REGISTRYINDEX, "ArrayMap");         // get weak table 'ArrayMap'
+    PushRegistryTable(L, ERegistryTable::ArrayMap);        // get weak table 'ArrayMap'
     lua_pushlightuserdata(L, Value);
     int32 Type = lua_rawget(L, -2);
     if (Type != LUA_TTABLE)
@@ -938,24 +1020,24 @@ void PushStructArray(lua_State *L, FProperty *Property, void *Value, const char
 
 /**
  * Create a Lua instance (table) for a UObject
+ *
+ * @param ModuleRef - reference of the required module in Lua registry
+ * @param NumFields - expected number of fields of the instance, to presize the table
  */
-int32 NewLuaObject(lua_State *L, UObjectBaseUtility *Object, UClass *Class, const char *ModuleName)
+int32 NewLuaObject(lua_State *L, UObjectBaseUtility *Object, int32 ModuleRef, int32 NumFields)
 {
     check(Object);
 
 	int OldTop = lua_gettop(L);
 
-    lua_getfield(L, LUA_REGISTRYINDEX, "ObjectMap");
+    PushRegistryTable(L, ERegistryTable::ObjectMap);
     lua_pushlightuserdata(L, Object);
-    lua_newtable(L);                                            // create a Lua table ('INSTANCE')
+    lua_createtable(L, 0, FMath::Max(NumFields, 1));            // create a Lua table ('INSTANCE')
     PushObjectCore(L, Object);                                  // push UObject ('RAW_UOBJECT')
-    lua_pushstring(L, "Object");
-    lua_pushvalue(L, -2);
-    lua_rawset(L, -4);                                          // INSTANCET.Object = RAW_UOBJECT
 
 	// in some case may occur module or object metatable can 
 	// not be found problem
-	int32 TypeModule = GetLoadedModule(L, ModuleName);          // push the required module/table ('REQUIRED_MODULE') to the top of the stack
+	int32 TypeModule = lua_rawgeti(L, LUA_REGISTRYINDEX, ModuleRef);   // push the required module/table ('REQUIRED_MODULE') to the top of the stack
 	int32 TypeMetatable = lua_getmetatable(L, -2);              // get the metatable ('METATABLE_UOBJECT') of 'RAW_UOBJECT' 
 	if ((TypeModule != LUA_TTABLE)
 		||(0 == TypeMetatable))
@@ -964,14 +1046,26 @@ int32 NewLuaObject(lua_State *L, UObjectBaseUtility *Object, UClass *Class, cons
 		return LUA_REFNIL;
 	}
 
+    // the module is shared by the instances, chain it to the class metatable only if it isn't yet
+    int32 HasMetatable = lua_getmetatable(L, -2);
+    if (HasMetatable && lua_rawequal(L, -1, -2))
+    {
+        lua_pop(L, 2);
+    }
+    else
+    {
+        lua_pop(L, HasMetatable);
 #if ENABLE_CALL_OVERRIDDEN_FUNCTION
-    lua_pushstring(L, "Overridden");
-    lua_pushvalue(L, -2);
-    lua_rawset(L, -4);
+        lua_pushstring(L, "Overridden");
+        lua_pushvalue(L, -2);
+        lua_rawset(L, -4);
 #endif
-    lua_setmetatable(L, -2);                                    // REQUIRED_MODULE.metatable = METATABLE_UOBJECT
+        lua_setmetatable(L, -2);                                // REQUIRED_MODULE.metatable = METATABLE_UOBJECT
+    }
     lua_setmetatable(L, -3);                                    // INSTANCE.metatable = REQUIRED_MODULE
-    lua_pop(L, 1);
+    lua_pushstring(L, "Object");
+    lua_insert(L, -2);
+    lua_rawset(L, -3);                                          // INSTANCE.Object = RAW_UOBJECT
     lua_pushvalue(L, -1);
     int32 ObjectRef = luaL_ref(L, LUA_REGISTRYINDEX);           // keep a reference for 'INSTANCE'
 
@@ -992,7 +1086,7 @@ void DeleteLuaObject(lua_State *L, UObjectBaseUtility *Object)
         return;
     }
 
-    lua_getfield(L, LUA_REGISTRYINDEX, "ObjectMap");            // get the object instance from 'ObjectMap'
+    PushRegistryTable(L, ERegistryTable::ObjectMap);           // get the object instance from 'ObjectMap'
     lua_pushlightuserdata(L, Object);
     int32 Type = lua_rawget(L, -2);
     if (Type == LUA_TTABLE || Type == LUA_TUSERDATA)
@@ -1030,7 +1124,7 @@ void DeleteLuaObject(lua_State *L, UObjectBaseUtility *Object)
 }
 
 /**
- * Delete the ref of uobject instance
+ * Delete all refs of uobject instance
  */
 void DeleteUObjectRefs(lua_State* L, UObjectBaseUtility* Object)
 {
@@ -1040,7 +1134,7 @@ void DeleteUObjectRefs(lua_State* L, UObjectBaseUtility* Object)
         UE_LOG(LogUnLua, Log, TEXT("UObject_Delete : %s,%p!"), *Object->GetName(), Object);
 #endif
         // unlua ref
-        GObjectReferencer.RemoveObjectRef((UObject*)Object);
+        GObjectReferencer.RemoveAllObjectRefs((UObject*)Object);
 
         // delegate ref, delegate must be clear before object is gced
         if (GLuaCxt->IsEnable())
@@ -1143,7 +1237,7 @@ bool GetObjectMapping(lua_State *L, UObjectBaseUtility *Object)
         return false;
     }
 
-    lua_getfield(L, LUA_REGISTRYINDEX, "ObjectMap");
+    PushRegistryTable(L, ERegistryTable::ObjectMap);
     lua_pushlightuserdata(L, Object);
     int32 Type = lua_rawget(L, -2);
     if (Type != LUA_TNIL)
@@ -1237,6 +1331,19 @@ bool CallFunction(lua_State *L, int32 NumArgs, int32 NumResults)
     return false;
 }
 
+/**
+ * Get the property referenced by a light userdata, it's either a descriptor handle or a statically exported property
+ */
+static UnLua::ITypeOps* GetPropertyFromUserdata(void *Userdata)
+{
+    if (FReflectionRegistry::IsDescHandle(Userdata))
+    {
+        return (FPropertyDesc*)GReflectionRegistry.FindDescWithObjectCheck(Userdata, DESC_PROPERTY);
+    }
+    UnLua::ITypeOps *Property = (UnLua::ITypeOps*)Userdata;
+    return Property && Property->StaticExported ? Property : nullptr;
+}
+
 /**
  * Push a field (property or function)
  */
@@ -1246,12 +1353,12 @@ static void PushField(lua_State *L, FFieldDesc *Field)
     if (Field->IsProperty())
     {
         FPropertyDesc *Property = Field->AsProperty();
-        lua_pushlightuserdata(L, Property);                     // Property
+        lua_pushlightuserdata(L, Property->GetHandle());        // Property
     }
     else
     {
         FFunctionDesc *Function = Field->AsFunction();
-        lua_pushlightuserdata(L, Function);                     // Function
+        lua_pushlightuserdata(L, Function->GetHandle());        // Function
         if (Function->IsLatentFunction())
         {
             lua_pushcclosure(L, Class_CallLatentFunction, 1);   // closure
@@ -1264,26 +1371,58 @@ static void PushField(lua_State *L, FFieldDesc *Field)
 }
 
 /**
- * Get a field (property or function)
+ * Push a field and cache it in the metatable, inherited fields are shared with the metatable of the outer class
  */
-static int32 GetField(lua_State* L)
+static void PushAndCacheField(lua_State *L, FFieldDesc *Field, int32 MetatableIndex, int32 KeyIndex)
 {
-    int32 Type = lua_getmetatable(L, 1);       // get meta table of table/userdata (first parameter passed in)
-    check(Type == 1 && lua_istable(L, -1));
+    if (Field->IsInherited())
+    {
+        int32 Type = luaL_getmetatable(L, TCHAR_TO_UTF8(*Field->GetOuterName()));
+        check(Type == LUA_TTABLE);
+        lua_pushvalue(L, KeyIndex);
+        Type = lua_rawget(L, -2);
+        if (Type == LUA_TNIL)
+        {
+            lua_pop(L, 1);
+            PushField(L, Field);                // Property / closure
+            lua_pushvalue(L, KeyIndex);         // key
+            lua_pushvalue(L, -2);               // Property / closure
+            lua_rawset(L, -4);
+        }
+        lua_remove(L, -2);
+    }
+    else
+    {
+        PushField(L, Field);                    // Property / closure
+    }
 
-    lua_pushvalue(L, 2);                    // push key
-    Type = lua_rawget(L, -2);
+    lua_pushvalue(L, KeyIndex);                 // key
+    lua_pushvalue(L, -2);                       // Property / closure
+    lua_rawset(L, MetatableIndex);
+}
+
+/**
+ * Push a field (property or function) of a class by its name, the field is looked up in the class metatable first
+ */
+static void PushFieldFromMetatable(lua_State *L, int32 MetatableIndex, int32 KeyIndex)
+{
+    lua_pushvalue(L, KeyIndex);             // push key
+    int32 Type = lua_rawget(L, MetatableIndex);
 
     if (Type == LUA_TNIL)
     {
         lua_pop(L, 1);
 
+        // slow path, the field isn't in the metatable yet
+        GLuaCxt->IncNumFieldSlowPathHits();
+        INC_DWORD_STAT(STAT_UnLua_GetField_SlowPath);
+
         lua_pushstring(L, "__name");
-        Type = lua_rawget(L, -2);
+        Type = lua_rawget(L, MetatableIndex);
         check(Type == LUA_TSTRING);
 
         const char* ClassName = lua_tostring(L, -1);
-        const char* FieldName = lua_tostring(L, 2);
+        const char* FieldName = lua_tostring(L, KeyIndex);
         lua_pop(L, 1);
 
         // desc maybe released on c++ side,but lua side may still hold it
@@ -1298,43 +1437,14 @@ static int32 GetField(lua_State* L)
             FFieldDesc* Field = ClassDesc->RegisterField(FieldName, ClassDesc);
             if (Field && Field->IsValid())
             {
-                bool bCached = false;
-                bool bInherited = Field->IsInherited();
-                if (bInherited)
-                {
-                    FString SuperStructName = Field->GetOuterName();
-                    Type = luaL_getmetatable(L, TCHAR_TO_UTF8(*SuperStructName));
-                    check(Type == LUA_TTABLE);
-                    lua_pushvalue(L, 2);
-                    Type = lua_rawget(L, -2);
-                    bCached = Type != LUA_TNIL;
-                    if (!bCached)
-                    {
-                        lua_pop(L, 1);
-                    }
-                }
-
-                if (!bCached)
-                {
-                    PushField(L, Field);                // Property / closure
-                    lua_pushvalue(L, 2);                // key
-                    lua_pushvalue(L, -2);               // Property / closure
-                    lua_rawset(L, -4);
-                }
-                if (bInherited)
-                {
-                    lua_remove(L, -2);
-                    lua_pushvalue(L, 2);                // key
-                    lua_pushvalue(L, -2);               // Property / closure
-                    lua_rawset(L, -4);
-                }
+                PushAndCacheField(L, Field, MetatableIndex, KeyIndex);
             }
             else
             {
                 if (ClassDesc->IsClass())
                 {
                     luaL_getmetatable(L, "UClass");
-                    lua_pushvalue(L, 2);                // push key
+                    lua_pushvalue(L, KeyIndex);         // push key
                     lua_rawget(L, -2);
                     lua_remove(L, -2);
                 }
@@ -1345,10 +1455,76 @@ static int32 GetField(lua_State* L)
             }
         }
     }
+}
+
+/**
+ * Get a field (property or function)
+ */
+static int32 GetField(lua_State* L)
+{
+    int32 Type = lua_getmetatable(L, 1);       // get meta table of table/userdata (first parameter passed in)
+    check(Type == 1 && lua_istable(L, -1));
+
+    PushFieldFromMetatable(L, lua_gettop(L), 2);
     lua_remove(L, -2);
     return 1;
 }
 
+/**
+ * Install all reflected properties and functions of a class into its metatable (on top of the stack) in one pass,
+ * so that field lookups never take the slow path of 'GetField'. fields already in the metatable are kept
+ */
+void PopulateClassMetatable(lua_State *L, FClassDesc *ClassDesc)
+{
+    check(lua_istable(L, -1));
+
+    if (!GReflectionRegistry.IsDescValid(ClassDesc, DESC_CLASS) || !ClassDesc->IsValid())
+    {
+        return;
+    }
+
+    if (ClassDesc->IsScriptStruct() && !ClassDesc->IsNative())
+    {
+        return;                                 // fields of user defined structs are looked up by display name, keep them lazy
+    }
+
+    TArray<FName> FieldNames;
+    UStruct *Struct = ClassDesc->AsStruct();
+    for (TFieldIterator<FProperty> It(Struct); It; ++It)
+    {
+        FieldNames.Add((*It)->GetFName());
+    }
+    UClass *Class = ClassDesc->AsClass();
+    if (Class)
+    {
+        for (TFieldIterator<UFunction> It(Class); It; ++It)
+        {
+            FieldNames.AddUnique((*It)->GetFName());    // overridden functions show up once per class in the chain
+        }
+    }
+
+    FScopedSafeClass SafeClass(ClassDesc);
+    const int32 MetatableIndex = lua_gettop(L);
+    for (const FName &FieldName : FieldNames)
+    {
+        lua_pushstring(L, TCHAR_TO_UTF8(*FieldName.ToString()));     // key
+        const int32 KeyIndex = lua_gettop(L);
+        lua_pushvalue(L, KeyIndex);
+        int32 Type = lua_rawget(L, MetatableIndex);
+        lua_pop(L, 1);
+        if (Type == LUA_TNIL)
+        {
+            FFieldDesc *Field = ClassDesc->RegisterField(FieldName, ClassDesc);
+            if (Field && Field->IsValid())
+            {
+                PushAndCacheField(L, Field, MetatableIndex, KeyIndex);
+                lua_pop(L, 1);
+            }
+        }
+        lua_pop(L, 1);
+    }
+}
+
 /**
  * Add a package path to package.path
  */
@@ -1538,6 +1714,32 @@ void CreateWeakValueTable(lua_State *L)
     lua_setmetatable(L, -2);
 }
 
+int32 GRegistryTableRefs[(int32)ERegistryTable::Num] = { LUA_NOREF, LUA_NOREF, LUA_NOREF, LUA_NOREF, LUA_NOREF };
+
+/**
+ * Create the tables in 'ERegistryTable'. they are also kept in the registry by name for scripts and debuggers
+ */
+void CreateRegistryTables(lua_State *L)
+{
+    static const char* TableNames[] = { "ObjectMap", "StructMap", "ScriptContainerMap", "ArrayMap", "NameCache" };
+    static_assert(UE_ARRAY_COUNT(TableNames) == (int32)ERegistryTable::Num, "Missing names of registry tables!");
+
+    for (int32 i = 0; i < (int32)ERegistryTable::Num; ++i)
+    {
+        if (i == (int32)ERegistryTable::NameCache)
+        {
+            lua_newtable(L);
+        }
+        else
+        {
+            CreateWeakValueTable(L);
+        }
+        lua_pushvalue(L, -1);
+        lua_setfield(L, LUA_REGISTRYINDEX, TableNames[i]);
+        GRegistryTableRefs[i] = luaL_ref(L, LUA_REGISTRYINDEX);
+    }
+}
+
 /**
  * Debug only...
  */
@@ -1815,12 +2017,21 @@ static bool RegisterClassCore(lua_State *L, FClassDesc *InClass, const FClassDes
     int32 Type = luaL_getmetatable(L, ClassName.Get());
     if (Type == LUA_TTABLE)
     {
-        lua_pop(L, 1);
+        if (InClass->GetMetatableRef() == LUA_NOREF)
+        {
+            InClass->SetMetatableRef(luaL_ref(L, LUA_REGISTRYINDEX));
+        }
+        else
+        {
+            lua_pop(L, 1);
+        }
         return true;
     }
     
     lua_pop(L, 1);
     luaL_newmetatable(L, ClassName.Get());                  // 1, will be used as meta table later (lua_setmetatable)
+    lua_pushvalue(L, -1);
+    InClass->SetMetatableRef(luaL_ref(L, LUA_REGISTRYINDEX));
 
     if (InSuperClass)
     {
@@ -1850,7 +2061,7 @@ static bool RegisterClassCore(lua_State *L, FClassDesc *InClass, const FClassDes
     UScriptStruct *ScriptStruct = InClass->AsScriptStruct();
     if (ScriptStruct)
     {
-        lua_pushlightuserdata(L, InClass);                  // FClassDesc
+        lua_pushlightuserdata(L, InClass->GetHandle());     // FClassDesc
 
         lua_pushstring(L, "Copy");                          // Key
         lua_pushvalue(L, -2);                               // FClassDesc
@@ -1892,7 +2103,7 @@ static bool RegisterClassCore(lua_State *L, FClassDesc *InClass, const FClassDes
             lua_rawset(L, -3);
 
             lua_pushstring(L, "StaticClass");               // Key
-            lua_pushlightuserdata(L, InClass);              // FClassDesc
+            lua_pushlightuserdata(L, InClass->GetHandle()); // FClassDesc
             lua_pushcclosure(L, Class_StaticClass, 1);      // closure
             lua_rawset(L, -3);
 
@@ -1921,6 +2132,11 @@ static bool RegisterClassCore(lua_State *L, FClassDesc *InClass, const FClassDes
         }
     }
 
+    if (GLuaCxt->IsEagerClassRegistration(InClass->AsStruct()))
+    {
+        PopulateClassMetatable(L, InClass);
+    }
+
     SetTableForClass(L, ClassName.Get());
 
     if (!InClass->IsNative())
@@ -2031,24 +2247,11 @@ int32 Global_GetUProperty(lua_State *L)
 {
     if (lua_islightuserdata(L, 2))
     {   
-        bool bValid = false;
-        UnLua::ITypeOps* Property = (UnLua::ITypeOps*)lua_touserdata(L, 2);
+        UnLua::ITypeOps* Property = GetPropertyFromUserdata(lua_touserdata(L, 2));
         if (Property)
         {
-			if (GReflectionRegistry.IsDescValidWithObjectCheck(Property, DESC_PROPERTY))
-			{
-				bValid = true;
-			}
-
-			if ((!bValid)
-				&& (Property->StaticExported))
-			{
-				bValid = true;
-			}
-
             UObject* Object = UnLua::GetUObject(L, 1);
-            if ((bValid)
-                && (GLuaCxt->IsUObjectValid(Object)))
+            if (GLuaCxt->IsUObjectValid(Object))
             {
                 Property->Read(L, Object, false);           // get UProperty value
                 return 1;
@@ -2064,28 +2267,149 @@ int32 Global_SetUProperty(lua_State *L)
 {
     if (lua_islightuserdata(L, 2))
     {
-        bool bValid = false;
-        UnLua::ITypeOps* Property = (UnLua::ITypeOps*)lua_touserdata(L, 2);
+        UnLua::ITypeOps* Property = GetPropertyFromUserdata(lua_touserdata(L, 2));
         if (Property)
         {   
-			if (GReflectionRegistry.IsDescValidWithObjectCheck(Property, DESC_PROPERTY))
-			{
-				bValid = true;
-			}
+            UObject* Object = UnLua::GetUObject(L, 1);
+            if (GLuaCxt->IsUObjectValid(Object))
+            {
+                Property->Write(L, Object, 3);              // set UProperty value
+            }
+        }
+    }
+    return 0;
+}
+
+bool IsPropertyOwnerTypeValid(UnLua::ITypeOps* InProperty, void* InContainerPtr);
 
-            if ((!bValid)
-                && (Property->StaticExported))
+/**
+ * Push the class metatable of a UObject (userdata or Lua instance), the object is validated only once for a batch of properties
+ */
+static UObject* PushObjectMetatable(lua_State *L, int32 Index)
+{
+    int32 Type = lua_type(L, Index);
+    if (Type == LUA_TTABLE)
+    {
+        lua_pushstring(L, "Object");
+        Type = lua_rawget(L, Index);                // raw UObject of the Lua instance
+    }
+    else
+    {
+        lua_pushvalue(L, Index);
+    }
+
+    UObject *Object = Type == LUA_TUSERDATA ? UnLua::GetUObject(L, -1) : nullptr;
+    if (!Object || !lua_getmetatable(L, -1))
+    {
+        lua_pop(L, 1);
+        return nullptr;
+    }
+    lua_remove(L, -2);
+    return Object;
+}
+
+/**
+ * Global glue function to read a batch of properties of a UObject, properties are returned in the order of the names.
+ * if a table is passed as the third parameter, properties are stored in it by name and the table is returned instead
+ *
+ * local Health, Ammo = UE.GetProperties(Object, {"Health", "Ammo"})
+ */
+int32 Global_GetProperties(lua_State *L)
+{
+    luaL_checktype(L, 2, LUA_TTABLE);
+    const bool bOutTable = lua_istable(L, 3);
+    lua_settop(L, 3);
+
+    UObject *Object = PushObjectMetatable(L, 1);
+    if (!Object)
+    {
+        return 0;
+    }
+
+    const int32 MetatableIndex = lua_gettop(L);
+    const int32 NumNames = (int32)lua_rawlen(L, 2);
+    if (!bOutTable)
+    {
+        luaL_checkstack(L, NumNames + LUA_MINSTACK, "too many properties");
+    }
+
+    for (int32 i = 1; i <= NumNames; ++i)
+    {
+        UnLua::ITypeOps *Property = nullptr;
+        if (lua_rawgeti(L, 2, i) == LUA_TSTRING)       // name
+        {
+            PushFieldFromMetatable(L, MetatableIndex, lua_gettop(L));
+            Property = lua_islightuserdata(L, -1) ? GetPropertyFromUserdata(lua_touserdata(L, -1)) : nullptr;     // functions are not properties
+            lua_pop(L, 1);
+        }
+
+        if (!Property)
+        {
+            // skip holes, non-string names and fields which are not properties, a nil is returned for them in order
+            lua_pop(L, 1);
+            if (!bOutTable)
             {
-                bValid = true;
+                lua_pushnil(L);
             }
+            continue;
+        }
 
-            UObject* Object = UnLua::GetUObject(L, 1);
-            if ((bValid)
-                && (GLuaCxt->IsUObjectValid(Object)))
+        Property->Read(L, Object, false);
+        if (bOutTable)
+        {
+            lua_rawset(L, 3);
+        }
+        else
+        {
+            lua_remove(L, -2);
+        }
+    }
+
+    if (bOutTable)
+    {
+        lua_pushvalue(L, 3);
+        return 1;
+    }
+    return NumNames;
+}
+
+/**
+ * Global glue function to write a batch of properties of a UObject
+ *
+ * UE.SetProperties(Object, {Health = 100, Ammo = 30})
+ */
+int32 Global_SetProperties(lua_State *L)
+{
+    luaL_checktype(L, 2, LUA_TTABLE);
+    lua_settop(L, 2);
+
+    UObject *Object = PushObjectMetatable(L, 1);
+    if (!Object)
+    {
+        return 0;
+    }
+
+    const int32 MetatableIndex = lua_gettop(L);
+    lua_pushnil(L);
+    while (lua_next(L, 2) != 0)                     // name, value
+    {
+        const int32 ValueIndex = lua_gettop(L);
+        if (lua_type(L, ValueIndex - 1) == LUA_TSTRING)
+        {
+            PushFieldFromMetatable(L, MetatableIndex, ValueIndex - 1);
+            UnLua::ITypeOps *Property = lua_islightuserdata(L, -1) ? GetPropertyFromUserdata(lua_touserdata(L, -1)) : nullptr;
+            if (Property)
             {
-                Property->Write(L, Object, 3);              // set UProperty value
+#if ENABLE_TYPE_CHECK
+                if (IsPropertyOwnerTypeValid(Property, Object))
+                    Property->Write(L, Object, ValueIndex);
+#else
+                Property->Write(L, Object, ValueIndex);
+#endif
             }
+            lua_pop(L, 1);
         }
+        lua_pop(L, 1);
     }
     return 0;
 }
@@ -2224,6 +2548,37 @@ int LoadFromCustomLoader(lua_State *L)
     return 1;
 }
 
+int LoadFromScriptArchive(lua_State *L)
+{
+    if (!GLuaScriptArchive.IsMounted())
+        return 0;
+
+    // 'a.b.c' -> 'a/b/c.lua', no conversion to TCHAR and no file system access
+    size_t NameSize = 0;
+    const char *ModuleName = lua_tolstring(L, 1, &NameSize);
+    TArray<char, TInlineAllocator<256>> RelativePath;
+    RelativePath.SetNumUninitialized(NameSize + 5);
+    for (size_t i = 0; i < NameSize; ++i)
+    {
+        RelativePath[i] = ModuleName[i] == '.' ? '/' : ModuleName[i];
+    }
+    FMemory::Memcpy(RelativePath.GetData() + NameSize, ".lua", 5);
+
+    const char *Chunk = nullptr;
+    int32 ChunkSize = 0;
+    if (!GLuaScriptArchive.Find(RelativePath.GetData(), NameSize + 4, Chunk, ChunkSize))
+        return 0;
+
+    // hot fixed scripts downloaded to 'ProjectPersistentDownloadDir' override the archive, they are loaded by 'LoadFromFileSystem'
+    if (!GetDownloadedFilePath(UTF8_TO_TCHAR(RelativePath.GetData())).IsEmpty())
+        return 0;
+
+    if (!UnLua::LoadChunk(L, Chunk, ChunkSize, RelativePath.GetData()))
+        return luaL_error(L, "file loading from script archive error");
+
+    return 1;
+}
+
 int LoadFromFileSystem(lua_State *L)
 {
     FString FileName(UTF8_TO_TCHAR(lua_tostring(L, 1)));
@@ -2238,7 +2593,7 @@ int LoadFromFileSystem(lua_State *L)
     const auto ChunkName = TCHAR_TO_UTF8(*RelativePath);
     const auto Chunk = (const char*)(Data.GetData() + SkipLen);
     const auto ChunkSize = Data.Num() - SkipLen;
-    if(!UnLua::LoadChunk(L, Chunk, ChunkSize, ChunkName))
+    if(!UnLua::LoadChunk(L, Chunk, ChunkSize, ChunkName, "bt", 0, true))
         return luaL_error(L, "file loading from file system error");
 
     return 1;
@@ -2410,25 +2765,11 @@ int32 Class_Index(lua_State *L)
     GetField(L);
     if (lua_islightuserdata(L, -1))
     {   
-        bool bValid = false;
-		UnLua::ITypeOps *Property = (UnLua::ITypeOps*)lua_touserdata(L, -1);
+        UnLua::ITypeOps *Property = GetPropertyFromUserdata(lua_touserdata(L, -1));
         if (Property)
         {
-			if (GReflectionRegistry.IsDescValidWithObjectCheck(Property, DESC_PROPERTY))
-			{
-				bValid = true;
-			}
-
-			if ((!bValid)
-				&& (Property->StaticExported))
-			{
-				bValid = true;
-			}
-
 			void* ContainerPtr = GetCppInstance(L, 1);
-
-			if ((bValid)
-				&& (ContainerPtr))
+			if (ContainerPtr)
 			{
 				Property->Read(L, ContainerPtr, false);
 				lua_remove(L, -2);
@@ -2473,12 +2814,11 @@ int32 Class_NewIndex(lua_State *L)
     GetField(L);
     if (lua_islightuserdata(L, -1))
     {
-        UnLua::ITypeOps* Property = (UnLua::ITypeOps*)lua_touserdata(L, -1);
+        UnLua::ITypeOps* Property = GetPropertyFromUserdata(lua_touserdata(L, -1));
         if (Property)
         {
-            const bool bValid = GReflectionRegistry.IsDescValidWithObjectCheck(Property, DESC_PROPERTY) || Property->StaticExported;
             void* ContainerPtr = GetCppInstance(L, 1);
-            if (bValid && ContainerPtr)
+            if (ContainerPtr)
             {
 #if ENABLE_TYPE_CHECK
                 if (IsPropertyOwnerTypeValid(Property, ContainerPtr))
@@ -2512,10 +2852,10 @@ int32 Class_CallUFunction(lua_State *L)
 {
     //!!!Fix!!!
     //delete desc when is not valid
-    FFunctionDesc *Function = (FFunctionDesc*)lua_touserdata(L, lua_upvalueindex(1));
-    if (!GReflectionRegistry.IsDescValidWithObjectCheck(Function,DESC_FUNCTION))
+    FFunctionDesc *Function = (FFunctionDesc*)GReflectionRegistry.FindDescWithObjectCheck(lua_touserdata(L, lua_upvalueindex(1)), DESC_FUNCTION);
+    if (!Function)
     {
-        UE_LOG(LogUnLua, Log, TEXT("%s: Invalid function descriptor! %p"), ANSI_TO_TCHAR(__FUNCTION__), Function);
+        UE_LOG(LogUnLua, Log, TEXT("%s: Invalid function descriptor! %p"), ANSI_TO_TCHAR(__FUNCTION__), lua_touserdata(L, lua_upvalueindex(1)));
         return 0;
     }
     int32 NumParams = lua_gettop(L);
@@ -2528,38 +2868,71 @@ int32 Class_CallUFunction(lua_State *L)
  */
 int32 Class_CallLatentFunction(lua_State *L)
 {
-    FFunctionDesc *Function = (FFunctionDesc*)lua_touserdata(L, lua_upvalueindex(1));
-	if (!GReflectionRegistry.IsDescValidWithObjectCheck(Function, DESC_FUNCTION))
+    FFunctionDesc *Function = (FFunctionDesc*)GReflectionRegistry.FindDescWithObjectCheck(lua_touserdata(L, lua_upvalueindex(1)), DESC_FUNCTION);
+	if (!Function)
     {
         UE_LOG(LogUnLua, Log, TEXT("%s: Invalid function descriptor!"), ANSI_TO_TCHAR(__FUNCTION__));
         return 0;
     }
 
-    int32 ThreadRef = GLuaCxt->FindThread(L);
+    FLuaCoroutineScheduler &Scheduler = GLuaCxt->GetCoroutineScheduler();
+    int32 ThreadRef = Scheduler.Register(L);
     if (ThreadRef == LUA_REFNIL)
     {
-        int32 Value = lua_pushthread(L);
-        if (Value == 1)
-        {
-            lua_pop(L, 1);
-            UNLUA_LOGERROR(L, LogUnLua, Warning, TEXT("%s: Can't call latent action in main lua thread!"), ANSI_TO_TCHAR(__FUNCTION__));
-            return 0;
-        }
-
-        ThreadRef = luaL_ref(L, LUA_REGISTRYINDEX);
-        GLuaCxt->AddThread(L, ThreadRef);
+        UNLUA_LOGERROR(L, LogUnLua, Warning, TEXT("%s: Can't call latent action in main lua thread!"), ANSI_TO_TCHAR(__FUNCTION__));
+        return 0;
     }
+    Scheduler.WaitForLatentAction(ThreadRef);
 
     int32 NumParams = lua_gettop(L);
     int32 NumResults = Function->CallUE(L, NumParams, &ThreadRef);
     return lua_yield(L, NumResults);
 }
 
+/**
+ * Global glue function to run a function in a pooled coroutine, latent functions can be called in it
+ *
+ * UnLua_StartCoroutine(Function, ...)
+ *
+ * @return - whether the coroutine is still alive
+ */
+int32 Global_StartCoroutine(lua_State *L)
+{
+    int32 NumParams = lua_gettop(L);
+    if (NumParams < 1 || lua_type(L, 1) != LUA_TFUNCTION)
+    {
+        UNLUA_LOGERROR(L, LogUnLua, Log, TEXT("%s: Invalid parameters!"), ANSI_TO_TCHAR(__FUNCTION__));
+        return 0;
+    }
+
+    int32 Handle = GLuaCxt->GetCoroutineScheduler().Start(L, 1, NumParams - 1);
+    lua_pushboolean(L, Handle != LUA_REFNIL);
+    return 1;
+}
+
+/**
+ * Global glue function to suspend the running coroutine for some game time
+ *
+ * UnLua_WaitSeconds(Seconds)
+ */
+int32 Global_WaitSeconds(lua_State *L)
+{
+    FLuaCoroutineScheduler &Scheduler = GLuaCxt->GetCoroutineScheduler();
+    int32 Handle = Scheduler.Register(L);
+    if (Handle == LUA_REFNIL)
+    {
+        UNLUA_LOGERROR(L, LogUnLua, Warning, TEXT("%s: Can't wait in main lua thread!"), ANSI_TO_TCHAR(__FUNCTION__));
+        return 0;
+    }
+
+    Scheduler.WaitForSeconds(Handle, (float)luaL_optnumber(L, 1, 0.0));
+    return lua_yield(L, 0);
+}
+
 FClassDesc* Class_CheckParam(lua_State *L)
 {
-    FClassDesc *ClassDesc = (FClassDesc*)lua_touserdata(L, lua_upvalueindex(1));
-    if ((!ClassDesc)
-        || (!GReflectionRegistry.IsDescValid(ClassDesc, DESC_CLASS)))
+    FClassDesc *ClassDesc = (FClassDesc*)GReflectionRegistry.FindDesc(lua_touserdata(L, lua_upvalueindex(1)), DESC_CLASS);
+    if (!ClassDesc)
     {
         UE_LOG(LogUnLua, Log, TEXT("Class : Invalid FClassDesc!"));
         return NULL;
@@ -2631,9 +3004,8 @@ int32 Class_Cast(lua_State* L)
 
 FClassDesc* ScriptStruct_CheckParam(lua_State *L)
 {
-    FClassDesc *ClassDesc = (FClassDesc*)lua_touserdata(L, lua_upvalueindex(1));
-    if ((!ClassDesc)
-        || (!GReflectionRegistry.IsDescValid(ClassDesc, DESC_CLASS)))
+    FClassDesc *ClassDesc = (FClassDesc*)GReflectionRegistry.FindDesc(lua_touserdata(L, lua_upvalueindex(1)), DESC_CLASS);
+    if (!ClassDesc)
     {
         UE_LOG(LogUnLua, Log, TEXT("ScriptStruct : Invalid FClassDesc!"));
         return NULL;
@@ -2667,7 +3039,8 @@ int32 ScriptStruct_New(lua_State *L)
     }
 
     UScriptStruct *ScriptStruct = ClassDesc->AsScriptStruct();
-    void *Userdata = NewUserdataWithPadding(L, ClassDesc->GetSize(), TCHAR_TO_UTF8(*ClassDesc->GetName()), ClassDesc->GetUserdataPadding());
+    void *Userdata = NewUserdataWithPadding(L, ClassDesc->GetSize(), nullptr, ClassDesc->GetUserdataPadding());
+    TryToSetMetatable(L, ClassDesc);
     ScriptStruct->InitializeStruct(Userdata);
 
     return 1;
@@ -2788,7 +3161,8 @@ int32 ScriptStruct_Copy(lua_State *L)
     }
     else
     {
-        Userdata = NewUserdataWithPadding(L, ClassDesc->GetSize(), TCHAR_TO_UTF8(*ClassDesc->GetName()), ClassDesc->GetUserdataPadding());
+        Userdata = NewUserdataWithPadding(L, ClassDesc->GetSize(), nullptr, ClassDesc->GetUserdataPadding());
+        TryToSetMetatable(L, ClassDesc);
         ScriptStruct->InitializeStruct(Userdata);
     }
     ScriptStruct->CopyScriptStruct(Userdata, Src);
@@ -36,6 +36,7 @@ private:
     const char *Name;
 };
 
+FString GetDownloadedFilePath(const FString& RelativePath);
 FString GetFullPathFromRelativePath(const FString& RelativePath);
 void CreateNamespaceForUE(lua_State *L);
 void SetTableForClass(lua_State *L, const char *Name);
@@ -44,6 +45,7 @@ void SetTableForClass(lua_State *L, const char *Name);
  * Set metatable for the userdata/table on the top of the stack
  */
 bool TryToSetMetatable(lua_State *L, const char *MetatableName, UObject* Object = nullptr);
+bool TryToSetMetatable(lua_State *L, class FClassDesc *ClassDesc);
 FString GetMetatableName(const UObjectBaseUtility* Object);
 
 /**
@@ -51,6 +53,8 @@ FString GetMetatableName(const UObjectBaseUtility* Object);
  */
 void* NewUserdataWithTwoLvPtrTag(lua_State* L, int Size, void* Object);
 void MarkUserdataTwoLvPtrTag(void* Userdata);
+UNLUA_API void AddUserdataObjectRef(lua_State *L, UObjectBaseUtility *Object);
+bool HasUserdataObjectRef(lua_State *L, int32 Index);
 UNLUA_API uint8 CalcUserdataPadding(int32 Alignment);
 template <typename T> uint8 CalcUserdataPadding() { return CalcUserdataPadding(alignof(T)); }
 UNLUA_API void* GetUserdata(lua_State *L, int32 Index, bool *OutTwoLvlPtr = nullptr, bool *OutClassMetatable = nullptr);
@@ -60,6 +64,24 @@ UNLUA_API void* NewUserdataWithPadding(lua_State *L, int32 Size, const char *Met
 UNLUA_API void* GetCppInstance(lua_State *L, int32 Index);
 UNLUA_API void* GetCppInstanceFast(lua_State *L, int32 Index);
 
+/**
+ * Tables that cache Lua values of C++ instances, they live in integer registry slots to skip string lookups
+ */
+enum class ERegistryTable : uint8
+{
+    ObjectMap,              // UObject -> userdata/Lua instance, weak
+    StructMap,              // pointer -> userdata, weak
+    ScriptContainerMap,     // script container -> userdata, weak
+    ArrayMap,               // static array -> table, weak
+    NameCache,              // FName without number -> Lua string, see UnLua::PushFName
+    Num
+};
+
+extern int32 GRegistryTableRefs[(int32)ERegistryTable::Num];
+
+void CreateRegistryTables(lua_State *L);
+FORCEINLINE int32 PushRegistryTable(lua_State *L, ERegistryTable Table) { return lua_rawgeti(L, LUA_REGISTRYINDEX, GRegistryTableRefs[(int32)Table]); }
+
 /**
  * Functions to handle script containers
  */
@@ -91,7 +113,7 @@ void PushObjectCore(lua_State *L, UObjectBaseUtility *Object);
 /**
  * Functions to New/Delete Lua instance for UObjectBaseUtility
  */
-int32 NewLuaObject(lua_State *L, UObjectBaseUtility *Object, UClass *Class, const char *ModuleName);
+int32 NewLuaObject(lua_State *L, UObjectBaseUtility *Object, int32 ModuleRef, int32 NumFields);
 void DeleteLuaObject(lua_State *L, UObjectBaseUtility *Object);
 void DeleteUObjectRefs(lua_State* L, UObjectBaseUtility* Object);
 
@@ -119,6 +141,7 @@ UNLUA_API bool GetObjectMapping(lua_State *L, UObjectBaseUtility *Object);
 UNLUA_API void AddPackagePath(lua_State *L, const char *Path);
 int LoadFromBuiltinLibs(lua_State *L);
 int LoadFromCustomLoader(lua_State *L);
+int LoadFromScriptArchive(lua_State *L);
 int LoadFromFileSystem(lua_State *L);
 
 /**
@@ -159,12 +182,15 @@ int32 Global_UnRegisterClass(lua_State* L);
 int32 Global_RegisterClass(lua_State *L);
 class FClassDesc* RegisterClass(lua_State *L, const char *ClassName, const char *SuperClassName = nullptr);
 class FClassDesc* RegisterClass(lua_State *L, UStruct *Struct, UStruct *SuperStruct = nullptr);
+void PopulateClassMetatable(lua_State *L, class FClassDesc *ClassDesc);
 
 /**
  * Lua global functions
  */
 int32 Global_GetUProperty(lua_State *L);
 int32 Global_SetUProperty(lua_State *L);
+int32 Global_GetProperties(lua_State *L);
+int32 Global_SetProperties(lua_State *L);
 int32 Global_LoadObject(lua_State *L);
 int32 Global_LoadClass(lua_State *L);
 int32 Global_NewObject(lua_State *L);
@@ -172,6 +198,8 @@ UNLUA_API int32 Global_Print(lua_State *L);
 UNLUA_API int32 Global_Require(lua_State *L);
 int32 Global_AddToClassWhiteSet(lua_State* L);
 int32 Global_RemoveFromClassWhiteSet(lua_State* L);
+int32 Global_StartCoroutine(lua_State *L);
+int32 Global_WaitSeconds(lua_State *L);
 
 /**
  * Functions to handle UEnum
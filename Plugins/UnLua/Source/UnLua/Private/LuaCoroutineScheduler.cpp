@@ -0,0 +1,311 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#include "LuaCoroutineScheduler.h"
+#include "UnLuaPrivate.h"
+#include "lua.hpp"
+
+static_assert(LUA_EXTRASPACE >= sizeof(int32), "the handle of a coroutine is stored in the extra space of its lua_State");
+
+static const int32 SlotIndexBits = 20;                              // up to 1M coroutines alive at the same time
+static const int32 SlotIndexMask = (1 << SlotIndexBits) - 1;
+static const uint16 MaxSerial = (1 << (31 - SlotIndexBits)) - 1;    // keep handles positive
+
+static FORCEINLINE int32& GetThreadHandle(lua_State *Thread)
+{
+    return *(int32*)lua_getextraspace(Thread);
+}
+
+FLuaCoroutineScheduler::FLuaCoroutineScheduler()
+    : L(nullptr), Time(0.0), FrameBudget(UNLUA_COROUTINE_FRAME_BUDGET_MS), NumScheduledResumes(0), NumDeferred(0)
+    , NumResumes(0), NumPoolHits(0), NumPoolMisses(0)
+{
+}
+
+void FLuaCoroutineScheduler::Initialize(lua_State *InL)
+{
+    check(InL && Slots.Num() == 0);
+    L = InL;
+    GetThreadHandle(L) = 0;             // new threads copy the extra space of the main thread
+}
+
+void FLuaCoroutineScheduler::Cleanup()
+{
+    // the Lua state is closed, all threads and references are gone already
+    L = nullptr;
+    Slots.Empty();
+    FreeSlots.Empty();
+    Pool.Empty();
+    ReadyHandles.Empty();
+    Timers.Empty();
+    Time = 0.0;
+    NumScheduledResumes = 0;
+    NumDeferred = 0;
+
+    SET_DWORD_STAT(STAT_UnLua_Coroutine_Live, 0);
+    SET_DWORD_STAT(STAT_UnLua_Coroutine_Pooled, 0);
+}
+
+int32 FLuaCoroutineScheduler::Register(lua_State *Thread)
+{
+    int32 Handle = Find(Thread);
+    if (Handle != LUA_REFNIL)
+    {
+        return Handle;
+    }
+
+    if (lua_pushthread(Thread) == 1)
+    {
+        lua_pop(Thread, 1);
+        return LUA_REFNIL;              // main thread
+    }
+    int32 ThreadRef = luaL_ref(Thread, LUA_REGISTRYINDEX);
+    return AddSlot(Thread, ThreadRef, false);
+}
+
+int32 FLuaCoroutineScheduler::Find(lua_State *Thread) const
+{
+    const int32 Handle = GetThreadHandle(Thread);
+    return Handle != 0 ? Handle : LUA_REFNIL;
+}
+
+bool FLuaCoroutineScheduler::Resume(int32 Handle, int32 NumArgs, lua_State *From)
+{
+    FSlot *Slot = FindSlot(Handle);
+    if (!Slot)
+    {
+        return false;                   // stale handle
+    }
+
+    const int32 SlotIndex = Handle & SlotIndexMask;
+    lua_State *Thread = Slot->Thread;   // 'Slots' may grow while the coroutine runs, don't touch 'Slot' after resuming
+    Slot->WaitType = EWaitType::Frame;
+    ++NumResumes;
+    INC_DWORD_STAT(STAT_UnLua_Coroutine_Resumes);
+
+#if 504 == LUA_VERSION_NUM
+    int NumResults = 0;
+    int32 Status = lua_resume(Thread, From ? From : L, NumArgs, &NumResults);
+    if (Status == LUA_YIELD)
+    {
+        lua_pop(Thread, NumResults);    // discard yielded values, they are not used by the next resume
+    }
+#else
+    int32 Status = lua_resume(Thread, From ? From : L, NumArgs);
+#endif
+
+    if (Status == LUA_YIELD)
+    {
+        const FSlot &YieldedSlot = Slots[SlotIndex];
+        if (YieldedSlot.WaitType == EWaitType::Frame)
+        {
+            if (YieldedSlot.bScheduled)
+            {
+                ReadyHandles.Add(Handle);   // plain yield, wait a frame
+            }
+            else
+            {
+                ReleaseSlot(SlotIndex, Status);     // plain yield, give the coroutine back to the Lua code resuming it
+            }
+        }
+        return true;
+    }
+
+    if (Status != LUA_OK)
+    {
+        UE_LOG(LogUnLua, Warning, TEXT("%s: coroutine failed: %s"), ANSI_TO_TCHAR(__FUNCTION__), UTF8_TO_TCHAR(lua_tostring(Thread, -1)));
+    }
+    ReleaseSlot(SlotIndex, Status);
+    return false;
+}
+
+int32 FLuaCoroutineScheduler::Start(lua_State *InL, int32 FuncIndex, int32 NumArgs)
+{
+    FuncIndex = lua_absindex(InL, FuncIndex);
+    FThread Thread = AcquireThread();
+    for (int32 i = 0; i <= NumArgs; ++i)
+    {
+        lua_pushvalue(InL, FuncIndex + i);
+    }
+    lua_xmove(InL, Thread.Thread, NumArgs + 1);
+
+    const int32 Handle = AddSlot(Thread.Thread, Thread.ThreadRef, true);
+    return Resume(Handle, NumArgs, InL) ? Handle : LUA_REFNIL;
+}
+
+void FLuaCoroutineScheduler::WaitForLatentAction(int32 Handle)
+{
+    if (FSlot *Slot = FindSlot(Handle))
+    {
+        Slot->WaitType = EWaitType::LatentAction;
+    }
+}
+
+void FLuaCoroutineScheduler::WaitForSeconds(int32 Handle, float Seconds)
+{
+    if (FSlot *Slot = FindSlot(Handle))
+    {
+        Slot->WaitType = EWaitType::Time;
+        Slot->WakeTime = Time + FMath::Max(Seconds, 0.0f);
+        Slot->bScheduled = true;
+        Timers.HeapPush({ Slot->WakeTime, Handle });
+    }
+}
+
+void FLuaCoroutineScheduler::Tick(float DeltaTime)
+{
+    SCOPE_CYCLE_COUNTER(STAT_UnLua_Coroutine_Tick);
+
+    Time += DeltaTime;
+    while (Timers.Num() > 0 && Timers.HeapTop().WakeTime <= Time)
+    {
+        FTimer Timer;
+        Timers.HeapPop(Timer, false);
+        FSlot *Slot = FindSlot(Timer.Handle);
+        if (Slot && Slot->WaitType == EWaitType::Time && Slot->WakeTime == Timer.WakeTime)
+        {
+            Slot->WaitType = EWaitType::Frame;
+            ReadyHandles.Add(Timer.Handle);
+        }
+    }
+
+    NumScheduledResumes = 0;
+    NumDeferred = 0;
+    if (ReadyHandles.Num() < 1)
+    {
+        return;
+    }
+
+    // coroutines yielding again in this tick are queued to 'ReadyHandles' for the next one
+    TArray<int32> Handles = MoveTemp(ReadyHandles);
+    ReadyHandles.Reset();
+
+    const double Deadline = FrameBudget > 0.0f ? FPlatformTime::Seconds() + FrameBudget * 0.001 : 0.0;
+    int32 Index = 0;
+    for (; Index < Handles.Num(); ++Index)
+    {
+        if (NumScheduledResumes > 0 && Deadline > 0.0 && FPlatformTime::Seconds() >= Deadline)
+        {
+            break;
+        }
+
+        const int32 Handle = Handles[Index];
+        const FSlot *Slot = FindSlot(Handle);
+        if (!Slot || Slot->WaitType != EWaitType::Frame)
+        {
+            continue;                   // finished or resumed by someone else in the meantime
+        }
+        ++NumScheduledResumes;
+        Resume(Handle);
+    }
+
+    NumDeferred = Handles.Num() - Index;
+    if (NumDeferred > 0)
+    {
+        // deferred coroutines go first in the next tick
+        Handles.RemoveAt(0, Index, false);
+        Handles.Append(ReadyHandles);
+        ReadyHandles = MoveTemp(Handles);
+    }
+
+    INC_DWORD_STAT_BY(STAT_UnLua_Coroutine_ScheduledResumes, NumScheduledResumes);
+    INC_DWORD_STAT_BY(STAT_UnLua_Coroutine_Deferred, NumDeferred);
+}
+
+int32 FLuaCoroutineScheduler::NewLatentUUID()
+{
+    static uint32 LatentUUID = 0;
+    return (int32)++LatentUUID;
+}
+
+FLuaCoroutineScheduler::FSlot* FLuaCoroutineScheduler::FindSlot(int32 Handle)
+{
+    const int32 SlotIndex = Handle & SlotIndexMask;
+    if (Handle <= 0 || !Slots.IsValidIndex(SlotIndex))
+    {
+        return nullptr;
+    }
+    FSlot &Slot = Slots[SlotIndex];
+    return Slot.Thread && Slot.Serial == (Handle >> SlotIndexBits) ? &Slot : nullptr;
+}
+
+int32 FLuaCoroutineScheduler::AddSlot(lua_State *Thread, int32 ThreadRef, bool bPooled)
+{
+    int32 SlotIndex;
+    if (FreeSlots.Num() > 0)
+    {
+        SlotIndex = FreeSlots.Pop(false);
+    }
+    else
+    {
+        check(Slots.Num() <= SlotIndexMask);
+        SlotIndex = Slots.Add({ nullptr, LUA_NOREF, 1, false, false, EWaitType::Frame, 0.0 });
+    }
+
+    FSlot &Slot = Slots[SlotIndex];
+    Slot.Thread = Thread;
+    Slot.ThreadRef = ThreadRef;
+    Slot.bPooled = bPooled;
+    Slot.bScheduled = bPooled;          // started by 'Start'
+    Slot.WaitType = EWaitType::Frame;
+
+    const int32 Handle = ((int32)Slot.Serial << SlotIndexBits) | SlotIndex;
+    GetThreadHandle(Thread) = Handle;
+
+    SET_DWORD_STAT(STAT_UnLua_Coroutine_Live, GetNumLiveCoroutines());
+    return Handle;
+}
+
+void FLuaCoroutineScheduler::ReleaseSlot(int32 SlotIndex, int32 Status)
+{
+    FSlot &Slot = Slots[SlotIndex];
+    GetThreadHandle(Slot.Thread) = 0;
+
+    // only threads which returned normally can run another function
+    if (Slot.bPooled && Status == LUA_OK && Pool.Num() < UNLUA_COROUTINE_POOL_SIZE)
+    {
+        lua_settop(Slot.Thread, 0);
+        Pool.Add({ Slot.Thread, Slot.ThreadRef });
+    }
+    else
+    {
+        luaL_unref(L, LUA_REGISTRYINDEX, Slot.ThreadRef);
+    }
+
+    Slot.Thread = nullptr;
+    Slot.ThreadRef = LUA_NOREF;
+    Slot.Serial = Slot.Serial < MaxSerial ? Slot.Serial + 1 : 1;
+    FreeSlots.Add(SlotIndex);
+
+    SET_DWORD_STAT(STAT_UnLua_Coroutine_Live, GetNumLiveCoroutines());
+    SET_DWORD_STAT(STAT_UnLua_Coroutine_Pooled, Pool.Num());
+}
+
+FLuaCoroutineScheduler::FThread FLuaCoroutineScheduler::AcquireThread()
+{
+    if (Pool.Num() > 0)
+    {
+        ++NumPoolHits;
+        INC_DWORD_STAT(STAT_UnLua_Coroutine_PoolHits);
+        SET_DWORD_STAT(STAT_UnLua_Coroutine_Pooled, Pool.Num() - 1);
+        return Pool.Pop(false);
+    }
+
+    ++NumPoolMisses;
+    FThread Thread;
+    Thread.Thread = lua_newthread(L);
+    Thread.ThreadRef = luaL_ref(L, LUA_REGISTRYINDEX);
+    return Thread;
+}
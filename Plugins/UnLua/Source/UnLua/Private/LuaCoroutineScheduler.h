@@ -0,0 +1,185 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#ifndef UNLUA_COROUTINE_POOL_SIZE
+#define UNLUA_COROUTINE_POOL_SIZE 64                // max number of finished Lua threads kept for reuse
+#endif
+
+#ifndef UNLUA_COROUTINE_FRAME_BUDGET_MS
+#define UNLUA_COROUTINE_FRAME_BUDGET_MS 2.0f        // default time budget of scheduled resumes per frame
+#endif
+
+struct lua_State;
+
+/**
+ * Keeps track of the Lua coroutines resumed from C++ (latent actions, coroutines started by UnLua_StartCoroutine).
+ *
+ * Registered coroutines live in a dense slot array. A handle packs the slot index with a serial number of the slot,
+ * so a stale handle (e.g. a latent action completing twice) never resumes a coroutine which reuses the slot. The handle
+ * is also stored in the extra space of the coroutine's lua_State, finding the handle of a coroutine costs no lookup.
+ * Threads of finished coroutines started by UnLua_StartCoroutine are pooled and reused.
+ *
+ * A coroutine started by UnLua_StartCoroutine or put to sleep by UnLua_WaitSeconds() is owned by the scheduler, if it
+ * yields without waiting for anything (coroutine.yield()) it's resumed next frame. Other coroutines (i.e. created by
+ * coroutine.create and waiting for a latent function) are unregistered by a plain yield and left to the Lua code
+ * resuming them. Scheduled resumes run in Tick() under a per-frame time budget, the coroutines which don't fit are
+ * deferred to the next frame in order.
+ */
+class FLuaCoroutineScheduler
+{
+public:
+    FLuaCoroutineScheduler();
+
+    /**
+     * Bind to a newly created Lua main thread, must be called before any coroutine is created
+     */
+    void Initialize(lua_State *InL);
+
+    /**
+     * Forget all coroutines and pooled threads, the Lua state is going to be closed
+     */
+    void Cleanup();
+
+    /**
+     * Register a coroutine
+     *
+     * @param Thread - the running coroutine
+     * @return - the handle of the coroutine, or LUA_REFNIL if 'Thread' is the main thread
+     */
+    int32 Register(lua_State *Thread);
+
+    /**
+     * Find the handle of a registered coroutine
+     *
+     * @return - the handle of the coroutine, or LUA_REFNIL if it's not registered
+     */
+    int32 Find(lua_State *Thread) const;
+
+    /**
+     * Resume a registered coroutine. The coroutine is unregistered once it finishes or raises an error.
+     *
+     * @param Handle - the handle of the coroutine
+     * @param NumArgs - number of arguments on the top of the coroutine's stack
+     * @param From - the Lua thread resuming the coroutine, the main thread if null
+     * @return - whether the coroutine is still alive (yielded)
+     */
+    bool Resume(int32 Handle, int32 NumArgs = 0, lua_State *From = nullptr);
+
+    /**
+     * Run the function at 'FuncIndex' with the following 'NumArgs' values as arguments in a pooled coroutine
+     *
+     * @return - the handle of the coroutine if it yielded, LUA_REFNIL if it already finished
+     */
+    int32 Start(lua_State *L, int32 FuncIndex, int32 NumArgs);
+
+    /**
+     * Mark a registered coroutine as waiting for a latent action, it's resumed by the action only
+     */
+    void WaitForLatentAction(int32 Handle);
+
+    /**
+     * Put a registered coroutine to sleep, it's resumed by Tick() once the time elapsed
+     */
+    void WaitForSeconds(int32 Handle, float Seconds);
+
+    /**
+     * Resume due coroutines within the frame budget, called once per frame
+     *
+     * @param DeltaTime - game time since the last tick
+     */
+    void Tick(float DeltaTime);
+
+    /**
+     * Set the time budget of scheduled resumes per frame. At least one coroutine is resumed every frame.
+     *
+     * @param Milliseconds - the budget, 0 or less means unlimited
+     */
+    FORCEINLINE void SetFrameBudget(float Milliseconds) { FrameBudget = Milliseconds; }
+    FORCEINLINE float GetFrameBudget() const { return FrameBudget; }
+
+    /**
+     * Get an UUID for a latent action. UUIDs only have to be unique among the pending latent actions of a callback target,
+     * so a monotonic counter does the job of a GUID.
+     */
+    static int32 NewLatentUUID();
+
+    FORCEINLINE int32 GetNumLiveCoroutines() const { return Slots.Num() - FreeSlots.Num(); }
+    FORCEINLINE int32 GetNumPooledThreads() const { return Pool.Num(); }
+    FORCEINLINE uint32 GetNumResumes() const { return NumResumes; }
+    FORCEINLINE uint32 GetNumPoolHits() const { return NumPoolHits; }
+    FORCEINLINE uint32 GetNumPoolMisses() const { return NumPoolMisses; }
+    FORCEINLINE int32 GetNumReadyCoroutines() const { return ReadyHandles.Num(); }
+    FORCEINLINE int32 GetNumSleepingCoroutines() const { return Timers.Num(); }
+    FORCEINLINE int32 GetNumScheduledResumesLastFrame() const { return NumScheduledResumes; }
+    FORCEINLINE int32 GetNumDeferredLastFrame() const { return NumDeferred; }
+
+private:
+    enum class EWaitType : uint8
+    {
+        Frame,                          // resumed by Tick() next frame
+        LatentAction,                   // resumed by the latent action
+        Time,                           // resumed by Tick() once 'WakeTime' is reached
+    };
+
+    struct FTimer
+    {
+        double WakeTime;
+        int32 Handle;
+
+        FORCEINLINE bool operator<(const FTimer &Other) const { return WakeTime < Other.WakeTime; }
+    };
+
+    struct FThread
+    {
+        lua_State *Thread;
+        int32 ThreadRef;                // reference in Lua registry
+    };
+
+    struct FSlot
+    {
+        lua_State *Thread;              // null if the slot is free
+        int32 ThreadRef;
+        uint16 Serial;
+        bool bPooled;                   // the thread is owned by the pool
+        bool bScheduled;                // plain yields are resumed by Tick(), otherwise by the owner of the coroutine
+        EWaitType WaitType;
+        double WakeTime;
+    };
+
+    FSlot* FindSlot(int32 Handle);
+    int32 AddSlot(lua_State *Thread, int32 ThreadRef, bool bPooled);
+    void ReleaseSlot(int32 SlotIndex, int32 Status);
+    FThread AcquireThread();
+
+    lua_State *L;
+    TArray<FSlot> Slots;
+    TArray<int32> FreeSlots;
+    TArray<FThread> Pool;
+    TArray<int32> ReadyHandles;         // coroutines to resume in the next tick, in order
+    TArray<FTimer> Timers;              // heap of sleeping coroutines
+
+    double Time;                        // accumulated game time of ticks
+    float FrameBudget;                  // milliseconds
+    int32 NumScheduledResumes;          // in the last tick
+    int32 NumDeferred;                  // ready coroutines which didn't fit in the budget of the last tick
+
+    uint32 NumResumes;
+    uint32 NumPoolHits;
+    uint32 NumPoolMisses;
+};
@@ -0,0 +1,196 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#include "LuaGCController.h"
+#include "UnLuaPrivate.h"
+#include "lua.hpp"
+
+static const int32 StepSize = 16;                   // KB of work per lua_gc call, small enough to check the deadline often
+static const int32 MaxPendingWork = 16 * 1024;      // KB, the automatic GC steps take over beyond that
+static const int32 DrainCycles = 3;                 // the cycle in progress marked the world alive, two more collect it and what its finalizers released
+
+FLuaGCController::FLuaGCController()
+    : L(nullptr), FrameBudget(UNLUA_GC_FRAME_BUDGET_MS), DrainBudget(UNLUA_GC_DRAIN_BUDGET_MS), bStepAfterEngineGC(UNLUA_GC_STEP_AFTER_ENGINE_GC != 0)
+    , LastMemory(0), PendingWork(0), AllocationRate(0.0f), NumDrainCycles(0), NumSteps(0), NumCycles(0)
+{
+}
+
+bool FLuaGCController::Initialize(lua_State *InL)
+{
+    check(InL);
+    if (FrameBudget <= 0.0f)
+    {
+        return false;
+    }
+
+    L = InL;
+#if 504 == LUA_VERSION_NUM
+    lua_gc(L, LUA_GCINC, 0, 0, 0);          // collections of the generational mode can't be sliced
+#else
+    lua_gc(L, LUA_GCSETPAUSE, 200);         // Lua defaults, the automatic steps are only a backstop
+    lua_gc(L, LUA_GCSETSTEPMUL, 200);
+#endif
+    LastMemory = GetMemory();
+    PendingWork = 0;
+    AllocationRate = 0.0f;
+    NumDrainCycles = 0;
+    NumSteps = 0;
+    return true;
+}
+
+void FLuaGCController::Cleanup()
+{
+    L = nullptr;
+    PendingWork = 0;
+    NumDrainCycles = 0;
+    NumSteps = 0;
+
+    SET_FLOAT_STAT(STAT_UnLua_GC_AllocationRate, 0.0f);
+}
+
+void FLuaGCController::Tick(float DeltaTime)
+{
+    if (!L)
+    {
+        return;
+    }
+
+    SCOPE_CYCLE_COUNTER(STAT_UnLua_GC_Tick);
+
+    NumSteps = 0;
+    const int32 Allocated = FMath::Max(GetMemory() - LastMemory, 0);
+    if (DeltaTime > 0.0f)
+    {
+        AllocationRate += (Allocated / DeltaTime - AllocationRate) * 0.1f;      // smoothed over ~10 frames
+    }
+
+    if (NumDrainCycles > 0)
+    {
+        const double Deadline = FPlatformTime::Seconds() + FMath::Max(DrainBudget, FrameBudget) * 0.001;
+        do
+        {
+            int32 Work = 0;
+            if (RunSteps(Deadline, Work))
+            {
+                --NumDrainCycles;
+            }
+        } while (NumDrainCycles > 0 && FPlatformTime::Seconds() < Deadline);
+        PendingWork = 0;
+    }
+    else if (FrameBudget > 0.0f)
+    {
+        // keep up with the allocations, what doesn't fit in the budget is done in the next frames
+        int32 Work = FMath::Min(PendingWork + FMath::Max(Allocated, StepSize), MaxPendingWork);
+        RunSteps(FPlatformTime::Seconds() + FrameBudget * 0.001, Work);
+        PendingWork = Work;
+    }
+
+    LastMemory = GetMemory();
+    SET_FLOAT_STAT(STAT_UnLua_GC_AllocationRate, AllocationRate);
+}
+
+void FLuaGCController::OnPostEngineGC()
+{
+    if (!L || !bStepAfterEngineGC || FrameBudget <= 0.0f)
+    {
+        return;
+    }
+
+    int32 Work = FMath::Max(PendingWork, StepSize);
+    RunSteps(FPlatformTime::Seconds() + FrameBudget * 0.001, Work);
+    PendingWork = Work;
+    LastMemory = GetMemory();
+}
+
+bool FLuaGCController::RequestDrain()
+{
+    if (!L)
+    {
+        return false;
+    }
+    NumDrainCycles = DrainCycles;
+    return true;
+}
+
+void FLuaGCController::FinishDrain()
+{
+    if (!L || NumDrainCycles < 1)
+    {
+        return;
+    }
+
+    // the second collection frees what the finalizers of the first one released
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    NumCycles += 2;
+    INC_DWORD_STAT_BY(STAT_UnLua_GC_Cycles, 2);
+
+    NumDrainCycles = 0;
+    PendingWork = 0;
+    LastMemory = GetMemory();
+}
+
+bool FLuaGCController::Step(float Milliseconds)
+{
+    if (!L)
+    {
+        return false;
+    }
+
+    const double Deadline = FPlatformTime::Seconds() + Milliseconds * 0.001;
+    bool bFinished = false;
+    do
+    {
+        int32 Work = 0;
+        bFinished = RunSteps(Deadline, Work);
+    } while (!bFinished && FPlatformTime::Seconds() < Deadline);
+
+    if (bFinished && NumDrainCycles > 0)
+    {
+        --NumDrainCycles;
+    }
+    LastMemory = GetMemory();
+    return bFinished;
+}
+
+int32 FLuaGCController::GetMemory() const
+{
+    return lua_gc(L, LUA_GCCOUNT, 0);
+}
+
+/**
+ * Run GC steps until 'Work' KB of work is done, the deadline passes or a GC cycle finishes. No work means a single
+ * basic step, which always makes progress, even starting a new cycle.
+ *
+ * @return - whether a GC cycle finished
+ */
+bool FLuaGCController::RunSteps(double Deadline, int32 &Work)
+{
+    do
+    {
+        const int32 StepWork = FMath::Min(Work, StepSize);
+        Work -= StepWork;
+        ++NumSteps;
+        if (lua_gc(L, LUA_GCSTEP, StepWork))
+        {
+            // the collector pauses until the heap grows again, so does the work of this tick
+            Work = 0;
+            ++NumCycles;
+            INC_DWORD_STAT(STAT_UnLua_GC_Cycles);
+            return true;
+        }
+    } while (Work > 0 && FPlatformTime::Seconds() < Deadline);
+    return false;
+}
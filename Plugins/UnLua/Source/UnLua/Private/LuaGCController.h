@@ -0,0 +1,125 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#ifndef UNLUA_GC_FRAME_BUDGET_MS
+#define UNLUA_GC_FRAME_BUDGET_MS 1.0f               // default time budget of Lua GC steps per frame, 0 or less leaves Lua GC alone
+#endif
+
+#ifndef UNLUA_GC_DRAIN_BUDGET_MS
+#define UNLUA_GC_DRAIN_BUDGET_MS 4.0f               // default time budget per frame of the drain after a world cleanup
+#endif
+
+#ifndef UNLUA_GC_STEP_AFTER_ENGINE_GC
+#define UNLUA_GC_STEP_AFTER_ENGINE_GC 0             // step Lua GC right after UE's GC as well, the frame has hitched already
+#endif
+
+struct lua_State;
+
+/**
+ * Drives the incremental Lua GC from the engine tick.
+ *
+ * Lua GC runs in incremental mode, its automatic steps stay on as a backstop. Every frame the controller adds as much
+ * work as the memory allocated since the last frame (at least one step), in steps of a few KB until the frame budget is
+ * used up. Work which doesn't fit in the budget carries over to the next frames, so an allocation burst is collected
+ * over several frames instead of stalling the one which triggers the collector.
+ *
+ * A world cleanup requests a drain instead of full collections: the collector runs with the drain budget every frame
+ * until the cycle in progress and two more cycles have finished. A drain still running when UE's GC starts (i.e. right
+ * after the world cleanup in LoadMap) is finished at once, UE's GC must not find the objects of the world referenced
+ * by Lua.
+ */
+class FLuaGCController
+{
+public:
+    FLuaGCController();
+
+    /**
+     * Bind to a newly created Lua main thread and switch Lua GC to incremental mode
+     *
+     * @return - false if the controller is disabled (frame budget is 0 or less), Lua GC is left alone
+     */
+    bool Initialize(lua_State *InL);
+
+    /**
+     * Forget the Lua state, it's going to be closed
+     */
+    void Cleanup();
+
+    /**
+     * Step Lua GC within the frame budget (or the drain budget), called once per frame
+     *
+     * @param DeltaTime - game time since the last tick
+     */
+    void Tick(float DeltaTime);
+
+    /**
+     * Callback after UE's GC, steps Lua GC within the frame budget if enabled by SetStepAfterEngineGC()
+     */
+    void OnPostEngineGC();
+
+    /**
+     * Collect the garbage left by a world over the next frames
+     *
+     * @return - false if the controller isn't bound to a Lua state, the caller should collect by itself
+     */
+    bool RequestDrain();
+
+    /**
+     * Finish a requested drain with full collections, called before UE's GC
+     */
+    void FinishDrain();
+
+    /**
+     * Step Lua GC for a time budget regardless of the allocations, e.g. on a loading screen
+     *
+     * @return - whether a GC cycle finished
+     */
+    bool Step(float Milliseconds);
+
+    FORCEINLINE bool IsEnabled() const { return L != nullptr; }
+    FORCEINLINE bool IsDraining() const { return NumDrainCycles > 0; }
+
+    FORCEINLINE void SetFrameBudget(float Milliseconds) { FrameBudget = Milliseconds; }
+    FORCEINLINE float GetFrameBudget() const { return FrameBudget; }
+    FORCEINLINE void SetDrainBudget(float Milliseconds) { DrainBudget = Milliseconds; }
+    FORCEINLINE float GetDrainBudget() const { return DrainBudget; }
+    FORCEINLINE void SetStepAfterEngineGC(bool bEnable) { bStepAfterEngineGC = bEnable; }
+
+    FORCEINLINE uint32 GetNumCycles() const { return NumCycles; }
+    FORCEINLINE int32 GetNumStepsLastFrame() const { return NumSteps; }
+    FORCEINLINE float GetAllocationRate() const { return AllocationRate; }
+    FORCEINLINE int32 GetPendingWork() const { return PendingWork; }
+
+private:
+    int32 GetMemory() const;
+    bool RunSteps(double Deadline, int32 &Work);
+
+    lua_State *L;
+
+    float FrameBudget;                  // milliseconds
+    float DrainBudget;                  // milliseconds
+    bool bStepAfterEngineGC;
+
+    int32 LastMemory;                   // KB in use after the last tick
+    int32 PendingWork;                  // KB of work which didn't fit in the budget of previous ticks
+    float AllocationRate;               // smoothed KB per second
+    int32 NumDrainCycles;               // GC cycles to finish before the drain ends
+    int32 NumSteps;                     // in the last tick
+    uint32 NumCycles;
+};
@@ -0,0 +1,167 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#include "LuaScriptArchive.h"
+#include "Algo/BinarySearch.h"
+#include "Hash/CityHash.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+
+FLuaScriptArchive GLuaScriptArchive;
+
+FLuaScriptArchive::FLuaScriptArchive()
+    : MappedHandle(nullptr), MappedRegion(nullptr), Data(nullptr), DataSize(0), Entries(nullptr), NumEntries(0), Names(nullptr), NamesSize(0)
+{
+}
+
+FLuaScriptArchive::~FLuaScriptArchive()
+{
+    Unmount();
+}
+
+/**
+ * Hash of a lower case name, names in an archive are case insensitive like the file system
+ */
+uint64 FLuaScriptArchive::HashName(const char *Name, int32 NameSize)
+{
+    TArray<char, TInlineAllocator<256>> LowerName;
+    LowerName.SetNumUninitialized(NameSize);
+    for (int32 i = 0; i < NameSize; ++i)
+    {
+        LowerName[i] = FCharAnsi::ToLower(Name[i]);
+    }
+    return CityHash64(LowerName.GetData(), NameSize);
+}
+
+bool FLuaScriptArchive::Mount(const FString &FilePath)
+{
+    Unmount();
+
+    IPlatformFile &PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    MappedHandle = PlatformFile.OpenMapped(*FilePath);
+    if (MappedHandle)
+    {
+        MappedRegion = MappedHandle->MapRegion(0, MappedHandle->GetFileSize());
+        if (MappedRegion)
+        {
+            Data = MappedRegion->GetMappedPtr();
+            DataSize = MappedRegion->GetMappedSize();
+        }
+    }
+    if (!Data)
+    {
+        Unmount();
+        if (!FFileHelper::LoadFileToArray(LoadedData, *FilePath, FILEREAD_Silent))
+        {
+            return false;
+        }
+        Data = LoadedData.GetData();
+        DataSize = LoadedData.Num();
+    }
+
+    const FHeader *Header = (const FHeader*)Data;
+    const int64 IndexSize = DataSize >= (int64)sizeof(FHeader) ? (int64)Header->NumEntries * sizeof(FEntry) : 0;
+    if (DataSize < (int64)sizeof(FHeader) || Header->Magic != ArchiveMagic || Header->Version != ArchiveVersion
+        || Header->IndexOffset % alignof(FEntry) != 0 || Header->IndexOffset + IndexSize > DataSize)
+    {
+        UE_LOG(LogUnLua, Warning, TEXT("Invalid Lua script archive %s!"), *FilePath);
+        Unmount();
+        return false;
+    }
+
+    Entries = (const FEntry*)(Data + Header->IndexOffset);
+    NumEntries = Header->NumEntries;
+    Names = (const char*)(Data + Header->IndexOffset + IndexSize);
+    NamesSize = DataSize - (Header->IndexOffset + IndexSize);
+
+    UE_LOG(LogUnLua, Log, TEXT("Lua script archive %s mounted, %d scripts%s"), *FilePath, NumEntries, MappedRegion ? TEXT(" (memory mapped)") : TEXT(""));
+    return true;
+}
+
+void FLuaScriptArchive::Unmount()
+{
+    delete MappedRegion;
+    MappedRegion = nullptr;
+    delete MappedHandle;
+    MappedHandle = nullptr;
+    LoadedData.Empty();
+    Data = nullptr;
+    DataSize = 0;
+    Entries = nullptr;
+    NumEntries = 0;
+    Names = nullptr;
+    NamesSize = 0;
+}
+
+bool FLuaScriptArchive::Find(const char *Name, int32 NameSize, const char *&OutData, int32 &OutSize) const
+{
+    if (!Data)
+    {
+        return false;
+    }
+
+    const uint64 NameHash = HashName(Name, NameSize);
+    int32 Index = Algo::LowerBoundBy(MakeArrayView(Entries, NumEntries), NameHash, [](const FEntry &Entry) { return Entry.NameHash; });
+    for (; Index < NumEntries && Entries[Index].NameHash == NameHash; ++Index)
+    {
+        const FEntry &Entry = Entries[Index];
+        if (Entry.NameSize == (uint32)NameSize && (int64)Entry.NameOffset + Entry.NameSize <= NamesSize
+            && FCStringAnsi::Strnicmp(Names + Entry.NameOffset, Name, NameSize) == 0)
+        {
+            if ((int64)Entry.DataOffset + Entry.DataSize > DataSize)
+            {
+                return false;
+            }
+            OutData = (const char*)(Data + Entry.DataOffset);
+            OutSize = Entry.DataSize;
+            return true;
+        }
+    }
+    return false;
+}
+
+void FLuaScriptArchive::Build(const TArray<FString> &InNames, const TArray<TArray<uint8>> &Scripts, TArray<uint8> &OutArchive)
+{
+    check(InNames.Num() == Scripts.Num());
+
+    TArray<FEntry> NewEntries;
+    TArray<char> NewNames;
+    NewEntries.SetNum(InNames.Num());
+    OutArchive.Reset();
+    OutArchive.AddZeroed(sizeof(FHeader));
+    for (int32 i = 0; i < InNames.Num(); ++i)
+    {
+        FTCHARToUTF8 Name(*InNames[i].ToLower());
+        FEntry &Entry = NewEntries[i];
+        Entry.NameHash = HashName(Name.Get(), Name.Length());
+        Entry.NameOffset = NewNames.Num();
+        Entry.NameSize = Name.Length();
+        Entry.DataOffset = OutArchive.Num();
+        Entry.DataSize = Scripts[i].Num();
+        NewNames.Append(Name.Get(), Name.Length());
+        OutArchive.Append(Scripts[i]);
+    }
+    NewEntries.Sort([](const FEntry &A, const FEntry &B) { return A.NameHash < B.NameHash; });
+
+    OutArchive.AddZeroed(Align(OutArchive.Num(), alignof(FEntry)) - OutArchive.Num());
+    FHeader *Header = (FHeader*)OutArchive.GetData();
+    Header->Magic = ArchiveMagic;
+    Header->Version = ArchiveVersion;
+    Header->NumEntries = NewEntries.Num();
+    Header->IndexOffset = OutArchive.Num();
+    OutArchive.Append((const uint8*)NewEntries.GetData(), NewEntries.Num() * sizeof(FEntry));
+    OutArchive.Append((const uint8*)NewNames.GetData(), NewNames.Num());
+}
@@ -0,0 +1,99 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#pragma once
+
+#include "UnLuaPrivate.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Packed archive of Lua scripts, memory mapped once and served to 'require' by an in-memory index lookup.
+ *
+ * Layout:
+ *   FHeader
+ *   script data (sources or bytecode), concatenated
+ *   FEntry[NumEntries] at 'IndexOffset', sorted by name hash
+ *   names (lower case paths relative to the script directory, e.g. 'foo/bar.lua'), concatenated
+ */
+class UNLUA_API FLuaScriptArchive
+{
+public:
+    enum
+    {
+        ArchiveMagic = 0x4B504C55,      // 'ULPK'
+        ArchiveVersion = 1,
+    };
+
+    struct FHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        uint32 NumEntries;
+        uint32 IndexOffset;
+    };
+
+    struct FEntry
+    {
+        uint64 NameHash;
+        uint32 NameOffset;              // relative to the names
+        uint32 NameSize;
+        uint32 DataOffset;              // relative to the archive
+        uint32 DataSize;
+    };
+
+    FLuaScriptArchive();
+    ~FLuaScriptArchive();
+
+    bool Mount(const FString &FilePath);
+    void Unmount();
+
+    FORCEINLINE bool IsMounted() const { return Data != nullptr; }
+
+    /**
+     * Get the path of the archive mounted at start up
+     */
+    static FString GetDefaultPath() { return GLuaSrcFullPath + TEXT("UnLuaScripts.ulpk"); }
+
+    /**
+     * Find a script by its path relative to the script directory (case insensitive). the data stays valid until unmounted
+     */
+    bool Find(const char *Name, int32 NameSize, const char *&OutData, int32 &OutSize) const;
+
+    /**
+     * Build an archive from scripts
+     *
+     * @param Names - paths relative to the script directory
+     * @param Scripts - sources or bytecode of the scripts
+     * @param OutArchive - the archive
+     */
+    static void Build(const TArray<FString> &Names, const TArray<TArray<uint8>> &Scripts, TArray<uint8> &OutArchive);
+
+private:
+    static uint64 HashName(const char *Name, int32 NameSize);
+
+    IMappedFileHandle *MappedHandle;
+    IMappedFileRegion *MappedRegion;
+    TArray<uint8> LoadedData;           // used if the archive can't be memory mapped, e.g. it's in a pak file
+    const uint8 *Data;
+    int64 DataSize;
+    const FEntry *Entries;
+    int32 NumEntries;
+    const char *Names;
+    int64 NamesSize;
+};
+
+extern FLuaScriptArchive GLuaScriptArchive;
@@ -0,0 +1,188 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#include "ObjectValidityTable.h"
+
+static const int32 MinTableCapacity = 64 * 1024;
+static const int32 RemovedSlot = -1;
+
+FObjectValidityTable::FObjectValidityTable()
+    : Current(nullptr), NumLive(0), NumUsed(0)
+{
+}
+
+FObjectValidityTable::~FObjectValidityTable()
+{
+    Empty();
+}
+
+/**
+ * Record a newly created UObject
+ */
+void FObjectValidityTable::Add(const UObjectBase *Object, int32 Index)
+{
+    FScopeLock Lock(&WriterCS);
+    FTable *Table = Current.load(std::memory_order_relaxed);
+    if (!Table || (NumUsed + 1) * 4 > Table->Capacity * 3)
+    {
+        Rehash();
+        Table = Current.load(std::memory_order_relaxed);
+    }
+    Insert(Table, Object, Index + 1);
+    ++NumLive;
+}
+
+/**
+ * Forget a deleted UObject
+ */
+void FObjectValidityTable::Remove(const UObjectBase *Object, int32 Index)
+{
+    FScopeLock Lock(&WriterCS);
+    FTable *Table = Current.load(std::memory_order_relaxed);
+    if (!Table)
+    {
+        return;
+    }
+
+    const uint32 Mask = Table->Capacity - 1;
+    uint32 Slot = HashObject(Object) & Mask;
+    for (int32 Probe = 0; Probe < Table->Capacity; ++Probe, Slot = (Slot + 1) & Mask)
+    {
+        const int32 Value = Table->Slots[Slot].load(std::memory_order_relaxed);
+        if (Value == 0)
+        {
+            break;
+        }
+        if (Value == Index + 1)
+        {
+            Table->Slots[Slot].store(RemovedSlot, std::memory_order_release);
+            --NumLive;
+            break;
+        }
+    }
+}
+
+/**
+ * Find the GUObjectArray index of a live UObject without locking. Returns INDEX_NONE if the object is unknown.
+ */
+int32 FObjectValidityTable::Find(const UObjectBase *Object) const
+{
+    const FTable *Table = Current.load(std::memory_order_acquire);
+    if (!Table)
+    {
+        return INDEX_NONE;
+    }
+
+    const uint32 Mask = Table->Capacity - 1;
+    uint32 Slot = HashObject(Object) & Mask;
+    for (int32 Probe = 0; Probe < Table->Capacity; ++Probe, Slot = (Slot + 1) & Mask)
+    {
+        const int32 Value = Table->Slots[Slot].load(std::memory_order_acquire);
+        if (Value == 0)
+        {
+            break;
+        }
+        if (Value > 0)
+        {
+            const FUObjectItem *ObjectItem = GUObjectArray.IndexToObject(Value - 1);
+            if (ObjectItem && ObjectItem->Object == Object)
+            {
+                return Value - 1;
+            }
+        }
+    }
+    return INDEX_NONE;
+}
+
+/**
+ * Free tables replaced by 'Rehash'. Must be called when no reader can be probing, e.g. after garbage collection.
+ */
+void FObjectValidityTable::ReclaimRetiredTables()
+{
+    FScopeLock Lock(&WriterCS);
+    for (FTable *Table : RetiredTables)
+    {
+        delete Table;
+    }
+    RetiredTables.Empty();
+}
+
+/**
+ * Free all tables
+ */
+void FObjectValidityTable::Empty()
+{
+    FScopeLock Lock(&WriterCS);
+    for (FTable *Table : RetiredTables)
+    {
+        delete Table;
+    }
+    RetiredTables.Empty();
+    delete Current.exchange(nullptr);
+    NumLive = 0;
+    NumUsed = 0;
+}
+
+/**
+ * Build a new table without removed slots (growing it if necessary) and publish it to readers
+ */
+void FObjectValidityTable::Rehash()
+{
+    FTable *OldTable = Current.load(std::memory_order_relaxed);
+    const int32 Capacity = (int32)FMath::RoundUpToPowerOfTwo((uint32)FMath::Max(MinTableCapacity, (NumLive + 1) * 2));
+    FTable *NewTable = new FTable(Capacity);
+
+    NumLive = 0;
+    NumUsed = 0;
+    if (OldTable)
+    {
+        for (int32 i = 0; i < OldTable->Capacity; ++i)
+        {
+            const int32 Value = OldTable->Slots[i].load(std::memory_order_relaxed);
+            if (Value > 0)
+            {
+                const FUObjectItem *ObjectItem = GUObjectArray.IndexToObject(Value - 1);
+                if (ObjectItem && ObjectItem->Object)
+                {
+                    Insert(NewTable, ObjectItem->Object, Value);
+                    ++NumLive;
+                }
+            }
+        }
+        RetiredTables.Add(OldTable);
+    }
+
+    Current.store(NewTable, std::memory_order_release);
+}
+
+void FObjectValidityTable::Insert(FTable *Table, const UObjectBase *Object, int32 Value)
+{
+    const uint32 Mask = Table->Capacity - 1;
+    uint32 Slot = HashObject(Object) & Mask;
+    while (true)
+    {
+        const int32 OldValue = Table->Slots[Slot].load(std::memory_order_relaxed);
+        if (OldValue <= 0)
+        {
+            if (OldValue == 0)
+            {
+                ++NumUsed;
+            }
+            Table->Slots[Slot].store(Value, std::memory_order_release);
+            return;
+        }
+        Slot = (Slot + 1) & Mask;
+    }
+}
@@ -0,0 +1,68 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#pragma once
+
+#include <atomic>
+#include "CoreMinimal.h"
+#include "UObject/UObjectArray.h"
+
+/**
+ * Table of live UObjects used to validate raw UObject pointers coming from Lua.
+ *
+ * Slots are open addressed by object pointer and store 'GUObjectArray index + 1', so every hit is confirmed against
+ * GUObjectArray and a stale slot never reports a dead object as alive. Writers (UObject create/delete listeners, which
+ * may run on the async loading thread) serialize on a writer-only lock, readers never lock.
+ */
+class FObjectValidityTable
+{
+public:
+    FObjectValidityTable();
+    ~FObjectValidityTable();
+
+    void Add(const UObjectBase *Object, int32 Index);
+    void Remove(const UObjectBase *Object, int32 Index);
+    int32 Find(const UObjectBase *Object) const;
+    void ReclaimRetiredTables();
+    void Empty();
+
+private:
+    struct FTable
+    {
+        explicit FTable(int32 InCapacity)
+            : Capacity(InCapacity), Slots(new std::atomic<int32>[InCapacity]())
+        {}
+
+        ~FTable() { delete[] Slots; }
+
+        int32 Capacity;                 // power of two
+        std::atomic<int32> *Slots;      // 0: empty, -1: removed, otherwise index in GUObjectArray + 1
+    };
+
+    static FORCEINLINE uint32 HashObject(const UObjectBase *Object)
+    {
+        const uint64 Key = (uint64)(UPTRINT)Object >> 4;
+        return (uint32)((Key * 0x9E3779B97F4A7C15ull) >> 32);
+    }
+
+    void Rehash();
+    void Insert(FTable *Table, const UObjectBase *Object, int32 Value);
+
+    std::atomic<FTable*> Current;
+    TArray<FTable*> RetiredTables;      // old tables are kept until no reader can be probing them
+    int32 NumLive;
+    int32 NumUsed;                      // live + removed slots
+    FCriticalSection WriterCS;
+};
@@ -27,9 +27,9 @@
  * Class descriptor constructor
  */
 FClassDesc::FClassDesc(UStruct *InStruct, const FString &InName, EType InType)
-    : Struct(InStruct), ClassName(InName), Type(InType), UserdataPadding(0), Size(0), RefCount(0), Locked(false),FunctionCollection(nullptr)
+    : Struct(InStruct), ClassName(InName), Type(InType), UserdataPadding(0), Size(0), RefCount(0), MetatableRef(LUA_NOREF), Locked(false),FunctionCollection(nullptr)
 {   
-	GReflectionRegistry.AddToDescSet(this, DESC_CLASS);
+	Handle = GReflectionRegistry.AddToDescSet(this, DESC_CLASS);
 
     if (InType == EType::CLASS)
     {
@@ -77,6 +77,11 @@ FClassDesc::~FClassDesc()
     }
 
     // remove lua side class tables
+    lua_State *L = *GLuaCxt;
+    if (L && MetatableRef != LUA_NOREF)
+    {
+        luaL_unref(L, LUA_REGISTRYINDEX, MetatableRef);
+    }
     FTCHARToUTF8 Utf8ClassName(*ClassName);
     ClearLibrary(*GLuaCxt, Utf8ClassName.Get());            // clean up related Lua meta table
     ClearLoadedModule(*GLuaCxt, Utf8ClassName.Get());       // clean up required Lua module
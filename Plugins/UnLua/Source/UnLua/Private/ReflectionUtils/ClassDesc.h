@@ -41,6 +41,8 @@ public:
 
     FORCEINLINE bool IsValid() const { return Type != EType::UNKNOWN && Struct && GLuaCxt->IsUObjectValid(Struct); }
 
+    FORCEINLINE void* GetHandle() const { return Handle; }
+
     FORCEINLINE bool IsScriptStruct() const { return Type == EType::SCRIPTSTRUCT; }
 
     FORCEINLINE bool IsClass() const { return Type == EType::CLASS; }
@@ -69,6 +71,10 @@ public:
 
     FORCEINLINE int32 GetRefCount() const { return RefCount; }
 
+    FORCEINLINE int32 GetMetatableRef() const { return MetatableRef; }
+
+    FORCEINLINE void SetMetatableRef(int32 InMetatableRef) { MetatableRef = InMetatableRef; }
+
     FORCEINLINE FPropertyDesc* GetProperty(int32 Index) { return Index > INDEX_NONE && Index < Properties.Num() ? Properties[Index] : nullptr; }
 
     FORCEINLINE FFunctionDesc* GetFunction(int32 Index) { return Index > INDEX_NONE && Index < Functions.Num() ? Functions[Index] : nullptr; }
@@ -103,10 +109,13 @@ private:
 
     FString ClassName;
 
+    void* Handle;                         // handle passed to Lua, see FReflectionRegistry::FindDesc
+
     EType Type;
     int32 UserdataPadding : 8;            // only used for UScriptStruct
     int32 Size : 24;
     int32 RefCount;
+    int32 MetatableRef;                   // registry reference of the metatable, so instances can be pushed without looking it up by name
     bool  Locked;
 
     //FClassDesc *Parent;
@@ -29,7 +29,7 @@ FFunctionDesc::FFunctionDesc(UFunction *InFunction, FParameterCollection *InDefa
     : Function(InFunction), DefaultParams(InDefaultParams), ReturnPropertyIndex(INDEX_NONE), LatentPropertyIndex(INDEX_NONE)
     , FunctionRef(InFunctionRef), NumRefProperties(0), NumCalls(0), bStaticFunc(false), bInterfaceFunc(false)
 {
-	GReflectionRegistry.AddToDescSet(this, DESC_FUNCTION);
+	Handle = GReflectionRegistry.AddToDescSet(this, DESC_FUNCTION);
 
     check(InFunction);
 
@@ -44,6 +44,7 @@ FFunctionDesc::FFunctionDesc(UFunction *InFunction, FParameterCollection *InDefa
     }
 
     bHasDelegateParams = false;
+    bCanForwardLuaParams = true;
     // create persistent parameter buffer. memory for speed
 #if ENABLE_PERSISTENT_PARAM_BUFFER
     Buffer = nullptr;
@@ -109,6 +110,34 @@ FFunctionDesc::FFunctionDesc(UFunction *InFunction, FParameterCollection *InDefa
             }
         }
 
+        if (bCanForwardLuaParams)
+        {
+            switch (PropertyDesc->GetPropertyType())
+            {
+            case CPT_Bool:
+            case CPT_Byte:
+            case CPT_Int8:
+            case CPT_Int16:
+            case CPT_UInt16:
+            case CPT_Int:
+            case CPT_UInt32:
+            case CPT_Int64:
+            case CPT_UInt64:
+            case CPT_Float:
+            case CPT_Double:
+            case CPT_Enum:
+            case CPT_String:
+            case CPT_Text:
+            case CPT_ObjectReference:
+                // non-const references write back, so they must go through UE. FName isn't forwarded, UE may change the case of the string
+                bCanForwardLuaParams = !Property->HasAnyPropertyFlags(CPF_OutParm | CPF_ReferenceParm) || Property->HasAnyPropertyFlags(CPF_ConstParm);
+                break;
+            default:
+                bCanForwardLuaParams = false;       // structs and containers are copied for every callee
+                break;
+            }
+        }
+
         if (!bHasDelegateParams && !PropertyDesc->IsReturnParameter())
         {
 			int8 PropertyType = PropertyDesc->GetPropertyType();
@@ -128,6 +157,10 @@ FFunctionDesc::FFunctionDesc(UFunction *InFunction, FParameterCollection *InDefa
         CurrentOutParmRec->NextOutParm = nullptr;
     }
 #endif
+
+#if ENABLE_CALL_PLAN
+    BuildCallPlan();
+#endif
 }
 
 /**
@@ -207,6 +240,7 @@ bool FFunctionDesc::CallLua(UObject *Context, FFrame &Stack, void *RetValueAddre
     {
         if (bUnpackParams)
         {
+            FScopedParamBufferMark ParamMark(GLuaCxt->GetParamBufferArena());
             void* Params = nullptr;
 #if ENABLE_PERSISTENT_PARAM_BUFFER
             if (!bHasDelegateParams)
@@ -216,7 +250,7 @@ bool FFunctionDesc::CallLua(UObject *Context, FFrame &Stack, void *RetValueAddre
 #endif      
             if (!Params)
             {
-                Params = Function->ParmsSize > 0 ? FMemory::Malloc(Function->ParmsSize, 16) : nullptr;
+                Params = Function->ParmsSize > 0 ? GLuaCxt->GetParamBufferArena().Alloc(Function->ParmsSize) : nullptr;
             }
 
             for (TFieldIterator<FProperty> It(Function); It && (It->PropertyFlags & CPF_Parm) == CPF_Parm; ++It)
@@ -227,15 +261,6 @@ bool FFunctionDesc::CallLua(UObject *Context, FFrame &Stack, void *RetValueAddre
             Stack.SkipCode(1);          // skip EX_EndFunctionParms
 
             bSuccess = CallLuaInternal(L, Params, Stack.OutParms, RetValueAddress);             // call Lua function...
-
-            if (Params)
-            {
-#if ENABLE_PERSISTENT_PARAM_BUFFER
-                if (bHasDelegateParams)
-#endif
-                FMemory::Free(Params);
-            }
-
         }
         else
         {
@@ -246,6 +271,19 @@ bool FFunctionDesc::CallLua(UObject *Context, FFrame &Stack, void *RetValueAddre
     return bSuccess;
 }
 
+/**
+ * Call a Lua function with the parameters of this UFunction
+ */
+bool FFunctionDesc::CallLua(UObject *Context, int32 InFunctionRef, FFrame &Stack, void *RetValueAddress)
+{
+    lua_State *L = *GLuaCxt;
+    if (!PushFunction(L, Context, InFunctionRef))
+    {
+        return false;
+    }
+    return CallLuaInternal(L, Stack.Locals, Stack.OutParms, RetValueAddress);       // call Lua function...
+}
+
 /**
  * Call the UFunction
  */
@@ -285,8 +323,8 @@ int32 FFunctionDesc::CallUE(lua_State *L, int32 NumParams, void *Userdata)
     bool bLocal = true;
 #endif
 
-    TArray<bool> CleanupFlags;
-    CleanupFlags.AddZeroed(Properties.Num());
+    FScopedParamBufferMark ParamMark(GLuaCxt->GetParamBufferArena());
+    TBitArray<> CleanupFlags(false, Properties.Num());      // inline storage, no heap allocation for common signatures
     void *Params = PreCall(L, NumParams, FirstParamIndex, CleanupFlags, Userdata);      // prepare values of properties
 
     UFunction *FinalFunction = Function;
@@ -299,13 +337,14 @@ int32 FFunctionDesc::CallUE(lua_State *L, int32 NumParams, void *Userdata)
         {
             UNLUA_LOGERROR(L, LogUnLua, Error, TEXT("ERROR! Can't find UFunction '%s' in target object!"), *FuncName);
 
-            if (Params)
+            for (int32 i = 0; i < Properties.Num(); ++i)
             {
-#if ENABLE_PERSISTENT_PARAM_BUFFER
-                if (NumCalls > 0 || bHasDelegateParams)
-#endif	
-                    FMemory::Free(Params);
+                if (CleanupFlags[i])
+                {
+                    Properties[i]->DestroyValue(Params);
+                }
             }
+            --NumCalls;
 
             return 0;
         }
@@ -371,14 +410,92 @@ int32 FFunctionDesc::ExecuteDelegate(lua_State *L, int32 NumParams, int32 FirstP
         return 0;
     }
 
-    TArray<bool> CleanupFlags;
-    CleanupFlags.AddZeroed(Properties.Num());
+    FScopedParamBufferMark ParamMark(GLuaCxt->GetParamBufferArena());
+    TBitArray<> CleanupFlags(false, Properties.Num());
     void *Params = PreCall(L, NumParams, FirstParamIndex, CleanupFlags);
     ScriptDelegate->ProcessDelegate<UObject>(Params);
     int32 NumReturnValues = PostCall(L, NumParams, FirstParamIndex, Params, CleanupFlags);
     return NumReturnValues;
 }
 
+/**
+ * Test if the Lua values of the parameters are exactly what UE would pass to a Lua callback, so they can be forwarded as they are
+ */
+bool FFunctionDesc::CheckForwardedLuaParams(lua_State *L, int32 FirstParamIndex) const
+{
+    for (int32 i = 0; i < Properties.Num(); ++i)
+    {
+        const int32 IndexInStack = FirstParamIndex + i;
+        FPropertyDesc *PropertyDesc = Properties[i];
+        lua_Integer MinValue = 0, MaxValue = 0;
+        switch (PropertyDesc->GetPropertyType())
+        {
+        case CPT_Bool:
+            if (lua_type(L, IndexInStack) != LUA_TBOOLEAN)
+            {
+                return false;
+            }
+            continue;
+        case CPT_Float:
+        case CPT_Double:
+            if (lua_type(L, IndexInStack) != LUA_TNUMBER || lua_isinteger(L, IndexInStack))
+            {
+                return false;
+            }
+            if (PropertyDesc->GetPropertyType() == CPT_Float)
+            {
+                const lua_Number Value = lua_tonumber(L, IndexInStack);
+                if ((lua_Number)(float)Value != Value)
+                {
+                    return false;       // UE rounds it to a float
+                }
+            }
+            continue;
+        case CPT_String:
+        case CPT_Text:
+            if (lua_type(L, IndexInStack) != LUA_TSTRING)
+            {
+                return false;
+            }
+            continue;
+        case CPT_ObjectReference:
+            if (!lua_isnil(L, IndexInStack))
+            {
+                UObject *Object = UnLua::GetUObject(L, IndexInStack);
+                FObjectPropertyBase *ObjectProperty = (FObjectPropertyBase*)PropertyDesc->GetProperty();
+                if (!Object || !Object->IsA(ObjectProperty->PropertyClass))
+                {
+                    return false;
+                }
+                FClassProperty *ClassProperty = CastField<FClassProperty>(ObjectProperty);
+                if (ClassProperty && !((UClass*)Object)->IsChildOf(ClassProperty->MetaClass))
+                {
+                    return false;
+                }
+            }
+            continue;
+        case CPT_Byte:      MinValue = 0;           MaxValue = MAX_uint8;   break;
+        case CPT_Int8:      MinValue = MIN_int8;    MaxValue = MAX_int8;    break;
+        case CPT_Int16:     MinValue = MIN_int16;   MaxValue = MAX_int16;   break;
+        case CPT_UInt16:    MinValue = 0;           MaxValue = MAX_uint16;  break;
+        case CPT_Int:       MinValue = MIN_int32;   MaxValue = MAX_int32;   break;
+        case CPT_UInt32:    MinValue = 0;           MaxValue = MAX_uint32;  break;
+        default:            MinValue = MIN_int64;   MaxValue = MAX_int64;   break;      // 64 bits integers and enums
+        }
+
+        if (!lua_isinteger(L, IndexInStack))
+        {
+            return false;
+        }
+        const lua_Integer Value = lua_tointeger(L, IndexInStack);
+        if (Value < MinValue || Value > MaxValue)
+        {
+            return false;       // UE truncates it
+        }
+    }
+    return true;
+}
+
 /**
  * Fire a multicast delegate
  */
@@ -389,8 +506,8 @@ void FFunctionDesc::BroadcastMulticastDelegate(lua_State *L, int32 NumParams, in
         return;
     }
 
-    TArray<bool> CleanupFlags;
-    CleanupFlags.AddZeroed(Properties.Num());
+    FScopedParamBufferMark ParamMark(GLuaCxt->GetParamBufferArena());
+    TBitArray<> CleanupFlags(false, Properties.Num());
     void *Params = PreCall(L, NumParams, FirstParamIndex, CleanupFlags);
     ScriptDelegate->ProcessMulticastDelegate<UObject>(Params);
     PostCall(L, NumParams, FirstParamIndex, Params, CleanupFlags);      // !!! have no return values for multi-cast delegates
@@ -399,10 +516,9 @@ void FFunctionDesc::BroadcastMulticastDelegate(lua_State *L, int32 NumParams, in
 /**
  * Prepare values of properties for the UFunction
  */
-void* FFunctionDesc::PreCall(lua_State *L, int32 NumParams, int32 FirstParamIndex, TArray<bool> &CleanupFlags, void *Userdata)
+void* FFunctionDesc::PreCall(lua_State *L, int32 NumParams, int32 FirstParamIndex, TBitArray<> &CleanupFlags, void *Userdata)
 {
-    // !!!Fix!!!
-    // use simple pool
+    // nested calls and functions with delegate parameters take their buffer from the arena, the caller holds a mark to release it
     void *Params = nullptr;
 #if ENABLE_PERSISTENT_PARAM_BUFFER
     if (NumCalls < 1 && !bHasDelegateParams)
@@ -411,10 +527,18 @@ void* FFunctionDesc::PreCall(lua_State *L, int32 NumParams, int32 FirstParamInde
     }
     else
 #endif
-    Params = Function->ParmsSize > 0 ? FMemory::Malloc(Function->ParmsSize, 16) : nullptr;
+    Params = Function->ParmsSize > 0 ? GLuaCxt->GetParamBufferArena().Alloc(Function->ParmsSize) : nullptr;
 
     ++NumCalls;
 
+#if ENABLE_CALL_PLAN
+    if (CanUseCallPlan(NumParams))
+    {
+        ExecuteCallPlan(L, FirstParamIndex, Params);        // values in a call plan never need cleanup
+        return Params;
+    }
+#endif
+
     int32 ParamIndex = 0;
     for (int32 i = 0; i < Properties.Num(); ++i)
     {
@@ -434,7 +558,7 @@ void* FFunctionDesc::PreCall(lua_State *L, int32 NumParams, int32 FirstParamInde
             }
 
             // bind a callback to the latent function
-            FLatentActionInfo LatentActionInfo(ThreadRef, GetTypeHash(FGuid::NewGuid()), TEXT("OnLatentActionCompleted"), (UObject*)GLuaCxt->GetManager());
+            FLatentActionInfo LatentActionInfo(ThreadRef, FLuaCoroutineScheduler::NewLatentUUID(), TEXT("OnLatentActionCompleted"), (UObject*)GLuaCxt->GetManager());
             Property->CopyValue(Params, &LatentActionInfo);
             continue;
         }
@@ -487,8 +611,16 @@ void* FFunctionDesc::PreCall(lua_State *L, int32 NumParams, int32 FirstParamInde
 /**
  * Handling 'out' properties
  */
-int32 FFunctionDesc::PostCall(lua_State *L, int32 NumParams, int32 FirstParamIndex, void *Params, const TArray<bool> &CleanupFlags)
+int32 FFunctionDesc::PostCall(lua_State *L, int32 NumParams, int32 FirstParamIndex, void *Params, const TBitArray<> &CleanupFlags)
 {
+#if ENABLE_CALL_PLAN
+    if (CanUseCallPlan(NumParams))
+    {
+        --NumCalls;
+        return PushCallPlanResult(L, Params);
+    }
+#endif
+
     int32 NumReturnValues = 0;
 
     if (ReturnPropertyIndex > INDEX_NONE)
@@ -532,16 +664,326 @@ int32 FFunctionDesc::PostCall(lua_State *L, int32 NumParams, int32 FirstParamInd
 
     --NumCalls;
 
-    if (Params)
+    return NumReturnValues;
+}
+
+#if ENABLE_CALL_PLAN
+/**
+ * Compile a single parameter into a call plan op. only zero constructed POD types with ArrayDim == 1 are supported
+ */
+static bool CompileCallPlanOp(FProperty *Property, int32 PropertyIndex, FCallPlanOp &Op, TArray<ANSICHAR> &TypeNames)
+{
+    if (Property->ArrayDim != 1)
     {
-#if ENABLE_PERSISTENT_PARAM_BUFFER
-        if (NumCalls > 0 || bHasDelegateParams)
-#endif	
-        FMemory::Free(Params);
+        return false;
     }
 
-    return NumReturnValues;
+    FProperty *ValueProperty = Property;
+    if (FEnumProperty *EnumProperty = CastField<FEnumProperty>(Property))
+    {
+        ValueProperty = EnumProperty->GetUnderlyingProperty();      // enums are marshalled as their underlying integers
+    }
+
+    Op.UserdataPadding = 0;
+    Op.PropertyIndex = (uint16)PropertyIndex;
+    Op.Offset = Property->GetOffset_ForInternal();
+    Op.Size = Property->ElementSize;
+#if ENABLE_TYPE_CHECK == 1
+    Op.ObjectClass = nullptr;
+    Op.TypeNameOffset = INDEX_NONE;
+#endif
+
+    switch (GetPropertyType(ValueProperty))
+    {
+    case CPT_Int8:
+        Op.Op = ECallPlanOp::Int8;
+        return true;
+    case CPT_Int16:
+        Op.Op = ECallPlanOp::Int16;
+        return true;
+    case CPT_Int:
+        Op.Op = ECallPlanOp::Int32;
+        return true;
+    case CPT_Int64:
+        Op.Op = ECallPlanOp::Int64;
+        return true;
+    case CPT_Byte:
+        Op.Op = ECallPlanOp::UInt8;
+        return true;
+    case CPT_UInt16:
+        Op.Op = ECallPlanOp::UInt16;
+        return true;
+    case CPT_UInt32:
+        Op.Op = ECallPlanOp::UInt32;
+        return true;
+    case CPT_UInt64:
+        Op.Op = ECallPlanOp::UInt64;
+        return true;
+    case CPT_Float:
+        Op.Op = ECallPlanOp::Float;
+        return true;
+    case CPT_Double:
+        Op.Op = ECallPlanOp::Double;
+        return true;
+    case CPT_Bool:
+        Op.Op = ECallPlanOp::Bool;
+        return CastField<FBoolProperty>(ValueProperty)->IsNativeBool();
+    case CPT_ObjectReference:
+        Op.Op = ECallPlanOp::Object;
+#if ENABLE_TYPE_CHECK == 1
+        Op.ObjectClass = CastField<FObjectProperty>(ValueProperty)->PropertyClass;
+#endif
+        return ValueProperty->GetClass() == FObjectProperty::StaticClass();    // no class/meta class checks, no object pointer wrappers
+    case CPT_Struct:
+        {
+            if (!ValueProperty->HasAllPropertyFlags(CPF_IsPlainOldData | CPF_ZeroConstructor))
+            {
+                return false;
+            }
+            FClassDesc *ClassDesc = RegisterClass(*GLuaCxt, CastField<FStructProperty>(ValueProperty)->Struct);
+            if (!ClassDesc)
+            {
+                return false;
+            }
+            Op.Op = ECallPlanOp::PODStruct;
+            Op.Size = ClassDesc->GetSize();
+            Op.UserdataPadding = ClassDesc->GetUserdataPadding();
+#if ENABLE_TYPE_CHECK == 1
+            FTCHARToUTF8 TypeName(*ClassDesc->GetName());
+            Op.TypeNameOffset = TypeNames.Num();
+            TypeNames.Append(TypeName.Get(), TypeName.Length() + 1);
+#endif
+            return true;
+        }
+    default:
+        return false;
+    }
+}
+
+/**
+ * Build the call plan. functions with latent info, delegates or non-const reference parameters keep the generic path
+ */
+void FFunctionDesc::BuildCallPlan()
+{
+    bHasCallPlan = false;
+    if (LatentPropertyIndex > INDEX_NONE || bHasDelegateParams || OutPropertyIndices.Num() > 0)
+    {
+        return;
+    }
+
+    TArray<FCallPlanOp> Ops;
+    TArray<ANSICHAR> TypeNames;
+    Ops.Reserve(Properties.Num());
+    for (int32 i = 0; i < Properties.Num(); ++i)
+    {
+        FCallPlanOp Op;
+        if (!CompileCallPlanOp(Properties[i]->GetProperty(), i, Op, TypeNames))
+        {
+            return;
+        }
+        if (i == ReturnPropertyIndex)
+        {
+            ReturnOp = Op;
+        }
+        else
+        {
+            Ops.Add(Op);
+        }
+    }
+
+    if (ReturnPropertyIndex > INDEX_NONE && ReturnOp.Op == ECallPlanOp::PODStruct)
+    {
+        UStruct *Struct = CastField<FStructProperty>(Properties[ReturnPropertyIndex]->GetProperty())->Struct;
+        FTCHARToUTF8 StructName(*FString::Printf(TEXT("F%s"), *Struct->GetName()));
+        ReturnStructName.Append(StructName.Get(), StructName.Length() + 1);
+    }
+
+    CallPlan = MoveTemp(Ops);
+#if ENABLE_TYPE_CHECK == 1
+    CallPlanTypeNames = MoveTemp(TypeNames);
+#endif
+    bHasCallPlan = true;
+}
+
+#if ENABLE_TYPE_CHECK == 1
+/**
+ * Check the type of a parameter inline. POD structs are matched by their exact metatable, so mismatches and
+ * derived structs are left to the property descriptor
+ */
+bool FFunctionDesc::CheckCallPlanParam(lua_State *L, int32 IndexInStack, const FCallPlanOp &Op) const
+{
+    int32 Type = lua_type(L, IndexInStack);
+    if (Type == LUA_TNIL)
+    {
+        return true;
+    }
+
+    switch (Op.Op)
+    {
+    case ECallPlanOp::Float:
+    case ECallPlanOp::Double:
+        return Type == LUA_TNUMBER;
+    case ECallPlanOp::Bool:
+        return Type == LUA_TBOOLEAN;
+    case ECallPlanOp::Object:
+        {
+            UObject *Object = UnLua::GetUObject(L, IndexInStack);
+            return !Object || Object->IsA(Op.ObjectClass);
+        }
+    case ECallPlanOp::PODStruct:
+        {
+            if (Type != LUA_TUSERDATA || !lua_getmetatable(L, IndexInStack))
+            {
+                return false;
+            }
+            luaL_getmetatable(L, &CallPlanTypeNames[Op.TypeNameOffset]);
+            bool bSameType = lua_rawequal(L, -1, -2) != 0;
+            lua_pop(L, 2);
+            return bSameType;
+        }
+    default:
+        return lua_isinteger(L, IndexInStack) != 0;     // integers and enums
+    }
 }
+#endif
+
+/**
+ * Run the call plan, set 'in' parameters from Lua stack
+ */
+void FFunctionDesc::ExecuteCallPlan(lua_State *L, int32 FirstParamIndex, void *Params) const
+{
+    if (!Params)
+    {
+        return;
+    }
+
+    FMemory::Memzero(Params, Function->ParmsSize);      // all types in a call plan are zero constructed
+
+    int32 IndexInStack = FirstParamIndex;
+    for (const FCallPlanOp &Op : CallPlan)
+    {
+#if ENABLE_TYPE_CHECK == 1
+        if (!CheckCallPlanParam(L, IndexInStack, Op))
+        {
+            FString ErrorMsg;
+            if (!Properties[Op.PropertyIndex]->CheckPropertyType(L, IndexInStack, ErrorMsg))
+            {
+                UNLUA_LOGERROR(L, LogUnLua, Warning, TEXT("Invalid parameter type calling ufunction : %s,parameter : %d, error msg : %s"), *FuncName, IndexInStack - FirstParamIndex, *ErrorMsg);
+            }
+        }
+#endif
+        uint8 *ValuePtr = (uint8*)Params + Op.Offset;
+        switch (Op.Op)
+        {
+        case ECallPlanOp::Int8:
+            *(int8*)ValuePtr = (int8)lua_tointeger(L, IndexInStack);
+            break;
+        case ECallPlanOp::Int16:
+            *(int16*)ValuePtr = (int16)lua_tointeger(L, IndexInStack);
+            break;
+        case ECallPlanOp::Int32:
+            *(int32*)ValuePtr = (int32)lua_tointeger(L, IndexInStack);
+            break;
+        case ECallPlanOp::Int64:
+            *(int64*)ValuePtr = (int64)lua_tointeger(L, IndexInStack);
+            break;
+        case ECallPlanOp::UInt8:
+            *(uint8*)ValuePtr = (uint8)lua_tointeger(L, IndexInStack);
+            break;
+        case ECallPlanOp::UInt16:
+            *(uint16*)ValuePtr = (uint16)lua_tointeger(L, IndexInStack);
+            break;
+        case ECallPlanOp::UInt32:
+            *(uint32*)ValuePtr = (uint32)lua_tointeger(L, IndexInStack);
+            break;
+        case ECallPlanOp::UInt64:
+            *(uint64*)ValuePtr = (uint64)lua_tointeger(L, IndexInStack);
+            break;
+        case ECallPlanOp::Float:
+            *(float*)ValuePtr = (float)lua_tonumber(L, IndexInStack);
+            break;
+        case ECallPlanOp::Double:
+            *(double*)ValuePtr = (double)lua_tonumber(L, IndexInStack);
+            break;
+        case ECallPlanOp::Bool:
+            *(bool*)ValuePtr = lua_toboolean(L, IndexInStack) != 0;
+            break;
+        case ECallPlanOp::Object:
+            *(UObject**)ValuePtr = UnLua::GetUObject(L, IndexInStack);
+            break;
+        case ECallPlanOp::PODStruct:
+            {
+                void *Value = GetCppInstanceFast(L, IndexInStack);
+                if (Value)
+                {
+                    FMemory::Memcpy(ValuePtr, Value, Op.Size);
+                }
+            }
+            break;
+        }
+        ++IndexInStack;
+    }
+}
+
+/**
+ * Push the return value of a call plan to Lua stack
+ */
+int32 FFunctionDesc::PushCallPlanResult(lua_State *L, void *Params) const
+{
+    if (ReturnPropertyIndex == INDEX_NONE)
+    {
+        return 0;
+    }
+
+    const uint8 *ValuePtr = (const uint8*)Params + ReturnOp.Offset;
+    switch (ReturnOp.Op)
+    {
+    case ECallPlanOp::Int8:
+        lua_pushinteger(L, *(const int8*)ValuePtr);
+        break;
+    case ECallPlanOp::Int16:
+        lua_pushinteger(L, *(const int16*)ValuePtr);
+        break;
+    case ECallPlanOp::Int32:
+        lua_pushinteger(L, *(const int32*)ValuePtr);
+        break;
+    case ECallPlanOp::Int64:
+        lua_pushinteger(L, *(const int64*)ValuePtr);
+        break;
+    case ECallPlanOp::UInt8:
+        lua_pushinteger(L, *(const uint8*)ValuePtr);
+        break;
+    case ECallPlanOp::UInt16:
+        lua_pushinteger(L, *(const uint16*)ValuePtr);
+        break;
+    case ECallPlanOp::UInt32:
+        lua_pushinteger(L, *(const uint32*)ValuePtr);
+        break;
+    case ECallPlanOp::UInt64:
+        lua_pushinteger(L, (lua_Integer)*(const uint64*)ValuePtr);
+        break;
+    case ECallPlanOp::Float:
+        lua_pushnumber(L, *(const float*)ValuePtr);
+        break;
+    case ECallPlanOp::Double:
+        lua_pushnumber(L, *(const double*)ValuePtr);
+        break;
+    case ECallPlanOp::Bool:
+        lua_pushboolean(L, *(const bool*)ValuePtr);
+        break;
+    case ECallPlanOp::Object:
+        UnLua::PushUObject(L, *(UObject* const*)ValuePtr);
+        break;
+    case ECallPlanOp::PODStruct:
+        {
+            void *Userdata = NewUserdataWithPadding(L, ReturnOp.Size, ReturnStructName.GetData(), ReturnOp.UserdataPadding);
+            FMemory::Memcpy(Userdata, ValuePtr, ReturnOp.Size);
+        }
+        break;
+    }
+    return 1;
+}
+#endif
 
 /**
  * Get OutParmRec for a non-const reference property
@@ -18,11 +18,50 @@
 #include "LuaContext.h"
 
 #define ENABLE_PERSISTENT_PARAM_BUFFER 1            // option to allocate persistent buffer for UFunction's parameters
+#define ENABLE_CALL_PLAN 1                          // option to marshal simple signatures with a pre-compiled call plan
 
 struct lua_State;
 struct FParameterCollection;
 class FPropertyDesc;
 
+#if ENABLE_CALL_PLAN
+/**
+ * Opcodes of a call plan
+ */
+enum class ECallPlanOp : uint8
+{
+    Int8,
+    Int16,
+    Int32,
+    Int64,
+    UInt8,
+    UInt16,
+    UInt32,
+    UInt64,
+    Float,
+    Double,
+    Bool,
+    Object,
+    PODStruct,
+};
+
+/**
+ * One step of a call plan, moves a single parameter between the Lua stack and the parameter buffer
+ */
+struct FCallPlanOp
+{
+    ECallPlanOp Op;
+    uint8 UserdataPadding;          // only used for 'PODStruct'
+    uint16 PropertyIndex;
+    int32 Offset;
+    int32 Size;
+#if ENABLE_TYPE_CHECK == 1
+    UClass *ObjectClass;            // only used for 'Object'
+    int32 TypeNameOffset;           // offset of the metatable name in 'CallPlanTypeNames', only used for 'PODStruct'
+#endif
+};
+#endif
+
 /**
  * Function descriptor
  */
@@ -41,6 +80,13 @@ public:
      */
     FORCEINLINE bool IsValid() const { return Function && GLuaCxt->IsUObjectValid(Function); }
 
+    /**
+     * Get the handle passed to Lua
+     *
+     * @return - the handle, see FReflectionRegistry::FindDesc
+     */
+    FORCEINLINE void* GetHandle() const { return Handle; }
+
     /**
      * Test if this function has return property
      *
@@ -90,6 +136,21 @@ public:
      */
     FORCEINLINE UFunction* GetFunction() const { return Function; }
 
+    /**
+     * Test if the Lua values of the parameters can be passed to a Lua function as they are, without marshalling them through UE
+     *
+     * @return - true if all parameters are passed by value and their Lua values are immutable or shared anyway (numbers, strings, UObjects...), see 'CheckForwardedLuaParams'
+     */
+    FORCEINLINE bool CanForwardLuaParams() const { return bCanForwardLuaParams; }
+
+    /**
+     * Test if the Lua values of the parameters can be forwarded as they are, they must be exactly what UE would pass to Lua
+     *
+     * @param FirstParamIndex - Lua index of the first parameter
+     * @return - true if every value has the type and the range of its property, false if it must be converted by UE
+     */
+    bool CheckForwardedLuaParams(lua_State *L, int32 FirstParamIndex) const;
+
     /**
      * Call Lua function that overrides this UFunction
      *
@@ -101,6 +162,16 @@ public:
      */
     bool CallLua(UObject *Context, FFrame &Stack, void *RetValueAddress, bool bRpcCall, bool bUnpackParams);
 
+    /**
+     * Call a Lua function with the parameters of this UFunction, used by the delegates whose callbacks share the UFunction
+     *
+     * @param InFunctionRef - reference of the Lua function
+     * @param Stack - script execution stack
+     * @param RetValueAddress - address of return value
+     * @return - true if the Lua function executes successfully, false otherwise
+     */
+    bool CallLua(UObject *Context, int32 InFunctionRef, FFrame &Stack, void *RetValueAddress);
+
     /**
      * Call this UFunction
      *
@@ -130,12 +201,25 @@ public:
     void BroadcastMulticastDelegate(lua_State *L, int32 NumParams, int32 FirstParamIndex, FMulticastScriptDelegate *ScriptDelegate);
 
 private:
-    void* PreCall(lua_State *L, int32 NumParams, int32 FirstParamIndex, TArray<bool> &CleanupFlags, void *Userdata = nullptr);
-    int32 PostCall(lua_State *L, int32 NumParams, int32 FirstParamIndex, void *Params, const TArray<bool> &CleanupFlags);
+    void* PreCall(lua_State *L, int32 NumParams, int32 FirstParamIndex, TBitArray<> &CleanupFlags, void *Userdata = nullptr);
+    int32 PostCall(lua_State *L, int32 NumParams, int32 FirstParamIndex, void *Params, const TBitArray<> &CleanupFlags);
 
     bool CallLuaInternal(lua_State *L, void *InParams, FOutParmRec *OutParams, void *RetValueAddress) const;
 
+#if ENABLE_CALL_PLAN
+    void BuildCallPlan();
+
+    FORCEINLINE bool CanUseCallPlan(int32 NumParams) const { return bHasCallPlan && NumParams == CallPlan.Num(); }
+
+    void ExecuteCallPlan(lua_State *L, int32 FirstParamIndex, void *Params) const;
+    int32 PushCallPlanResult(lua_State *L, void *Params) const;
+#if ENABLE_TYPE_CHECK == 1
+    bool CheckCallPlanParam(lua_State *L, int32 IndexInStack, const FCallPlanOp &Op) const;
+#endif
+#endif
+
     UFunction *Function;
+    void *Handle;
     FString FuncName;
 #if ENABLE_PERSISTENT_PARAM_BUFFER
     void *Buffer;
@@ -146,6 +230,14 @@ private:
     TArray<FPropertyDesc*> Properties;
     TArray<int32> OutPropertyIndices;
     FParameterCollection *DefaultParams;
+#if ENABLE_CALL_PLAN
+    TArray<FCallPlanOp> CallPlan;               // ops for the 'in' parameters, in Lua stack order
+    FCallPlanOp ReturnOp;
+    TArray<ANSICHAR> ReturnStructName;          // metatable name if the return value is a POD struct
+#if ENABLE_TYPE_CHECK == 1
+    TArray<ANSICHAR> CallPlanTypeNames;         // metatable names of the POD struct parameters
+#endif
+#endif
     int32 ReturnPropertyIndex;
     int32 LatentPropertyIndex;
     int32 FunctionRef;
@@ -154,4 +246,8 @@ private:
     uint8 bStaticFunc : 1;
     uint8 bInterfaceFunc : 1;
     uint8 bHasDelegateParams : 1;
+    uint8 bCanForwardLuaParams : 1;
+#if ENABLE_CALL_PLAN
+    uint8 bHasCallPlan : 1;
+#endif
 };
@@ -0,0 +1,84 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#include "ParamBufferArena.h"
+#include "UnLuaPrivate.h"
+
+static const int32 ParamBufferChunkSize = 16 * 1024;
+
+FParamBufferArena::FParamBufferArena()
+    : CurrentChunk(0), CurrentOffset(0)
+{
+}
+
+FParamBufferArena::~FParamBufferArena()
+{
+    Cleanup();
+}
+
+/**
+ * Move to the next chunk, reuse it if it's big enough
+ */
+void* FParamBufferArena::AllocSlow(int32 Size, int32 Alignment)
+{
+    if (CurrentChunk < Chunks.Num() && CurrentOffset > 0)
+    {
+        ++CurrentChunk;
+    }
+
+    const int32 NeededSize = Size + Alignment;
+    if (CurrentChunk < Chunks.Num() && Chunks[CurrentChunk].Size < NeededSize)
+    {
+        // chunks after the current one are not in use, replace the small one
+#if STATS
+        DEC_MEMORY_STAT_BY(STAT_UnLua_ParamBufferArena_Memory, Chunks[CurrentChunk].Size);
+#endif
+        FMemory::Free(Chunks[CurrentChunk].Data);
+        Chunks.RemoveAt(CurrentChunk);
+    }
+
+    if (CurrentChunk >= Chunks.Num())
+    {
+        FChunk Chunk;
+        Chunk.Size = FMath::Max(ParamBufferChunkSize, NeededSize);
+        Chunk.Data = (uint8*)FMemory::Malloc(Chunk.Size, 16);
+        Chunks.Insert(Chunk, CurrentChunk);
+#if STATS
+        INC_DWORD_STAT(STAT_UnLua_ParamBuffer_HeapAllocs);
+        INC_MEMORY_STAT_BY(STAT_UnLua_ParamBufferArena_Memory, Chunk.Size);
+#endif
+    }
+
+    const int32 Offset = Align(0, Alignment);       // chunk data is 16 bytes aligned
+    CurrentOffset = Offset + Size;
+    return Chunks[CurrentChunk].Data + Offset;
+}
+
+/**
+ * Free all chunks
+ */
+void FParamBufferArena::Cleanup()
+{
+    for (const FChunk &Chunk : Chunks)
+    {
+#if STATS
+        DEC_MEMORY_STAT_BY(STAT_UnLua_ParamBufferArena_Memory, Chunk.Size);
+#endif
+        FMemory::Free(Chunk.Data);
+    }
+    Chunks.Empty();
+    CurrentChunk = 0;
+    CurrentOffset = 0;
+}
@@ -0,0 +1,92 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Bump allocator for parameter buffers of UFunction calls. Calls are strictly nested, so memory is released by
+ * restoring a mark (see FScopedParamBufferMark) and chunks are reused, no heap allocation happens in steady state.
+ */
+class FParamBufferArena
+{
+public:
+    struct FMark
+    {
+        int32 ChunkIndex;
+        int32 Offset;
+    };
+
+    FParamBufferArena();
+    ~FParamBufferArena();
+
+    FORCEINLINE FMark GetMark() const { return { CurrentChunk, CurrentOffset }; }
+
+    FORCEINLINE void PopMark(const FMark &Mark)
+    {
+        CurrentChunk = Mark.ChunkIndex;
+        CurrentOffset = Mark.Offset;
+    }
+
+    FORCEINLINE void* Alloc(int32 Size, int32 Alignment = 16)
+    {
+        if (CurrentChunk < Chunks.Num())
+        {
+            const int32 Offset = Align(CurrentOffset, Alignment);
+            if (Offset + Size <= Chunks[CurrentChunk].Size)
+            {
+                CurrentOffset = Offset + Size;
+                return Chunks[CurrentChunk].Data + Offset;
+            }
+        }
+        return AllocSlow(Size, Alignment);
+    }
+
+    void Cleanup();
+
+private:
+    void* AllocSlow(int32 Size, int32 Alignment);
+
+    struct FChunk
+    {
+        uint8 *Data;
+        int32 Size;
+    };
+
+    TArray<FChunk> Chunks;
+    int32 CurrentChunk;
+    int32 CurrentOffset;
+};
+
+/**
+ * Release all parameter buffers allocated in a scope
+ */
+class FScopedParamBufferMark
+{
+public:
+    explicit FScopedParamBufferMark(FParamBufferArena &InArena)
+        : Arena(InArena), Mark(InArena.GetMark())
+    {}
+
+    ~FScopedParamBufferMark()
+    {
+        Arena.PopMark(Mark);
+    }
+
+private:
+    FParamBufferArena &Arena;
+    FParamBufferArena::FMark Mark;
+};
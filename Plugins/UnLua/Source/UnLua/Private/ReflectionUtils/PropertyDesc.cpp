@@ -26,7 +26,7 @@ TMap<FProperty*,FPropertyDesc*> FPropertyDesc::Property2Desc;
 
 FPropertyDesc::FPropertyDesc(FProperty *InProperty) : Property(InProperty) 
 { 
-	GReflectionRegistry.AddToDescSet(this, DESC_PROPERTY); 
+	Handle = GReflectionRegistry.AddToDescSet(this, DESC_PROPERTY);
     Property2Desc.Add(Property,this);
     PropertyType = CPT_None;
 }
@@ -602,7 +602,7 @@ public:
         }
         else
         {
-            lua_pushstring(L, TCHAR_TO_UTF8(*NameProperty->GetPropertyValue(ValuePtr).ToString()));
+            UnLua::PushFName(L, NameProperty->GetPropertyValue(ValuePtr));
         }
     }
 
@@ -646,13 +646,13 @@ public:
         }
         else
         {
-            lua_pushstring(L, TCHAR_TO_UTF8(*StringProperty->GetPropertyValue(ValuePtr)));
+            UnLua::PushFString(L, StringProperty->GetPropertyValue(ValuePtr));
         }
     }
 
     virtual bool SetValueInternal(lua_State *L, void *ValuePtr, int32 IndexInStack, bool bCopyValue) const override
     {
-        StringProperty->SetPropertyValue(ValuePtr, UTF8_TO_TCHAR(lua_tostring(L, IndexInStack)));
+        StringProperty->SetPropertyValue(ValuePtr, UnLua::GetFString(L, IndexInStack));
         return true;
     }
 
@@ -690,13 +690,13 @@ public:
         }
         else
         {
-            lua_pushstring(L, TCHAR_TO_UTF8(*TextProperty->GetPropertyValue(ValuePtr).ToString()));
+            UnLua::PushFString(L, TextProperty->GetPropertyValue(ValuePtr).ToString());
         }
     }
 
     virtual bool SetValueInternal(lua_State* L, void* ValuePtr, int32 IndexInStack, bool bCopyValue) const override
     {
-        TextProperty->SetPropertyValue(ValuePtr, FText::FromString(UTF8_TO_TCHAR(lua_tostring(L, IndexInStack))));
+        TextProperty->SetPropertyValue(ValuePtr, FText::FromString(UnLua::GetFString(L, IndexInStack)));
         return true;
     }
 
@@ -1191,6 +1191,7 @@ public:
         FClassDesc *ClassDesc = RegisterClass(*GLuaCxt, StructProperty->Struct);    // register UScriptStruct first
         StructSize = ClassDesc->GetSize();
         UserdataPadding = ClassDesc->GetUserdataPadding();                          // padding size for userdata
+        ClassHandle = ClassDesc->GetHandle();
 
         //ClassDesc->AddRef();
     }
@@ -1201,6 +1202,7 @@ public:
         FClassDesc *ClassDesc = RegisterClass(*GLuaCxt, StructProperty->Struct);
         StructSize = ClassDesc->GetSize();
         UserdataPadding = ClassDesc->GetUserdataPadding();
+        ClassHandle = ClassDesc->GetHandle();
         bFirstPropOfScriptStruct = false;
     }
 
@@ -1250,7 +1252,17 @@ public:
     {
         if (bCreateCopy)
         {
-            void *Userdata = NewUserdataWithPadding(L, StructSize, StructName.Get(), UserdataPadding);
+            void *Userdata;
+            FClassDesc *ClassDesc = (FClassDesc*)GReflectionRegistry.FindDesc(ClassHandle, DESC_CLASS);
+            if (ClassDesc)
+            {
+                Userdata = NewUserdataWithPadding(L, StructSize, nullptr, UserdataPadding);
+                TryToSetMetatable(L, ClassDesc);                // set metatable by the reference held by the class
+            }
+            else
+            {
+                Userdata = NewUserdataWithPadding(L, StructSize, StructName.Get(), UserdataPadding);
+            }
             StructProperty->InitializeValue(Userdata);
             StructProperty->CopySingleValue(Userdata, ValuePtr);
         }
@@ -1334,6 +1346,7 @@ public:
 
 private:
     TStringConversion<TStringConvert<TCHAR, ANSICHAR>> StructName;
+    void *ClassHandle;
     int32 StructSize;
     uint8 UserdataPadding;
 };
@@ -48,6 +48,13 @@ public:
      */
     bool IsValid() const;
 
+    /**
+     * Get the handle passed to Lua
+     *
+     * @return - the handle, see FReflectionRegistry::FindDesc
+     */
+    FORCEINLINE void* GetHandle() const { return Handle; }
+
     /**
      * Test if this property is a const reference parameter.
      *
@@ -205,6 +212,7 @@ protected:
         FMulticastDelegateProperty *MulticastDelegateProperty;
     };
 
+    void *Handle;
     int8 PropertyType;
 public:
     static TMap<FProperty*,FPropertyDesc*> Property2Desc;
@@ -53,8 +53,15 @@ void FReflectionRegistry::Cleanup()
     Struct2Classes.Empty();
     Enums.Empty();
     Functions.Empty();
-	DescSet.Empty();
-    GCSet.Empty();
+
+    // invalidate handles of descriptors which are still alive
+    TArray<void*> Descs;
+    DescSet.GetKeys(Descs);
+    for (void* Desc : Descs)
+    {
+        RemoveFromDescSet(Desc);
+    }
+
     ClassWhiteSet.Empty();
 }
 
@@ -346,6 +353,7 @@ bool FReflectionRegistry::UnRegisterFunction(UFunction* InFunction)
 bool FReflectionRegistry::NotifyUObjectDeleted(const UObjectBase* InObject)
 {   
     UObject* Object = (UObject*)InObject;
+    const bool bCollectedByLua = GObjectReferencer.NotifyUObjectDeleted(InObject);     // also drops the references held by Lua
 
     FClassDesc* ClassDesc = nullptr;
     if (Struct2Classes.RemoveAndCopyValue((UStruct*)InObject, ClassDesc))
@@ -363,17 +371,13 @@ bool FReflectionRegistry::NotifyUObjectDeleted(const UObjectBase* InObject)
         // non class object,check class
         
         // check lua use this object or not
-        bool bNeedProcess = IsInGCSet(Object);
-        if (bNeedProcess)
-        {
-            RemoveFromGCSet(Object);
-        }
-        else
+        bool bNeedProcess = bCollectedByLua;
+        if (!bNeedProcess)
         {
             lua_State* L = UnLua::GetState();
             if (L)
             {
-                lua_getfield(UnLua::GetState(), LUA_REGISTRYINDEX, "ObjectMap");            // get the object instance from 'ObjectMap'
+                PushRegistryTable(L, ERegistryTable::ObjectMap);            // get the object instance from 'ObjectMap'
                 lua_pushlightuserdata(L, Object);
                 int32 Type = lua_rawget(L, -2);
                 lua_pop(L, 2);
@@ -387,14 +391,13 @@ bool FReflectionRegistry::NotifyUObjectDeleted(const UObjectBase* InObject)
             UClass* Class = Object->GetClass();
             if (GLuaCxt->IsUObjectValid(Class))
             {
-                FString ClassName = FString::Printf(TEXT("%s%s"), Class->GetPrefixCPP(), *Class->GetName());
-                ClassDesc = FindClass(TCHAR_TO_UTF8(*ClassName));
+                ClassDesc = FindClass(Class);
                 if (ClassDesc)
                 {
                     ClassDesc->SubRef();
 
 #if UNLUA_ENABLE_DEBUG != 0
-                    UE_LOG(LogUnLua, Log, TEXT("FReflectionRegistry::NotifyUObjectDeleted:%p,%s"),Object, *ClassName);
+                    UE_LOG(LogUnLua, Log, TEXT("FReflectionRegistry::NotifyUObjectDeleted:%p,%s"),Object, *ClassDesc->GetName());
 #endif
                     TryUnRegisterClass(ClassDesc);
                 }
@@ -435,20 +438,46 @@ UFunction* FReflectionRegistry::FindOverriddenFunction(UFunction *NewFunc)
 #endif
 
 
-void FReflectionRegistry::AddToDescSet(void* Desc, EDescType type)
+void* FReflectionRegistry::AddToDescSet(void* Desc, EDescType type)
 {
-	DescSet.Add(Desc, type);
+    int32 Index;
+    if (FreeDescSlots.Num() > 0)
+    {
+        Index = FreeDescSlots.Pop(false);
+    }
+    else
+    {
+        Index = DescSlots.AddZeroed();
+        check(Index < (1 << DESC_HANDLE_INDEX_BITS));
+    }
+
+    FDescSlot& Slot = DescSlots[Index];
+    Slot.Desc = Desc;
+    Slot.Type = type;
+	DescSet.Add(Desc, Index);
+    return (void*)(((UPTRINT)Slot.Generation << (DESC_HANDLE_INDEX_BITS + 1)) | ((UPTRINT)Index << 1) | 1);
 }
 
 void FReflectionRegistry::RemoveFromDescSet(void* Desc)
 {
-	DescSet.Remove(Desc);
+    int32 Index;
+    if (!DescSet.RemoveAndCopyValue(Desc, Index))
+    {
+        return;
+    }
+
+    // invalidate all handles of this slot
+    FDescSlot& Slot = DescSlots[Index];
+    Slot.Desc = nullptr;
+    Slot.Type = DESC_NONE;
+    Slot.Generation = (uint32)(((UPTRINT)Slot.Generation + 1) & (~(UPTRINT)0 >> (DESC_HANDLE_INDEX_BITS + 1)));
+    FreeDescSlots.Add(Index);
 }
 
 bool FReflectionRegistry::IsDescValid(void* Desc, EDescType type)
 {   
-    EDescType* TypePtr = DescSet.Find(Desc);
-    return TypePtr && (*TypePtr == type);
+    const int32* Index = DescSet.Find(Desc);
+    return Index && (DescSlots[*Index].Type == type);
 }
 
 bool FReflectionRegistry::IsDescValidWithObjectCheck(void* Desc, EDescType type)
@@ -478,21 +507,33 @@ bool FReflectionRegistry::IsDescValidWithObjectCheck(void* Desc, EDescType type)
     return bValid;
 }
 
-void FReflectionRegistry::AddToGCSet(const UObject* InObject)
-{   
-    GCSet.Add(InObject,true);
-}
-
-
-void FReflectionRegistry::RemoveFromGCSet(const UObject* InObject)
+void* FReflectionRegistry::FindDescWithObjectCheck(const void* Handle, EDescType type) const
 {
-    GCSet.Remove(InObject);
-}
-
+    void* Desc = FindDesc(Handle, type);
+    if (!Desc)
+    {
+        return nullptr;
+    }
 
-bool FReflectionRegistry::IsInGCSet(const UObject* InObject)
-{
-    return GCSet.Contains(InObject);
+    bool bValid;
+    switch (type)
+    {
+    case DESC_CLASS:
+        bValid = ((FClassDesc*)Desc)->IsValid();
+        break;
+    case DESC_FUNCTION:
+        bValid = ((FFunctionDesc*)Desc)->IsValid();
+        break;
+    case DESC_PROPERTY:
+        bValid = ((FPropertyDesc*)Desc)->IsValid();
+        break;
+    case DESC_ENUM:
+        bValid = ((FEnumDesc*)Desc)->IsValid();
+        break;
+    default:
+        bValid = false;
+    }
+    return bValid ? Desc : nullptr;
 }
 
 
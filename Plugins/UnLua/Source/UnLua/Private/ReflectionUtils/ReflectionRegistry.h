@@ -33,6 +33,16 @@ enum EDescType
 	DESC_ENUM = 5,
 };
 
+/**
+ * Descriptor handles passed to Lua as light userdata. The lowest bit is always set so a handle can't be mistaken for
+ * the (aligned) pointer of a statically exported property, the other bits hold a slot index and the slot generation.
+ */
+#if PLATFORM_64BITS
+#define DESC_HANDLE_INDEX_BITS 31
+#else
+#define DESC_HANDLE_INDEX_BITS 20
+#endif
+
 /**
  * Reflection registry
  */
@@ -47,6 +57,15 @@ public:
     // all other place should use this to found desc!
     FClassDesc* FindClass(const char* InName);
 
+    /**
+     * Find the descriptor of a registered class without building its name
+     */
+    FORCEINLINE FClassDesc* FindClass(UStruct* InStruct) const
+    {
+        FClassDesc* const* ClassDesc = Struct2Classes.Find(InStruct);
+        return ClassDesc ? *ClassDesc : nullptr;
+    }
+
     void TryUnRegisterClass(FClassDesc* ClassDesc);
     bool UnRegisterClass(FClassDesc *ClassDesc);
     FClassDesc* RegisterClass(const char* InName);
@@ -69,14 +88,37 @@ public:
 
     bool NotifyUObjectDeleted(const UObjectBase* InObject);
 
-	void AddToDescSet(void* Desc, EDescType type);
+	void* AddToDescSet(void* Desc, EDescType type);
 	void RemoveFromDescSet(void* Desc);
 	bool IsDescValid(void* Desc, EDescType type);
     bool IsDescValidWithObjectCheck(void* Desc, EDescType type);
 
-    void AddToGCSet(const UObject* InObject);
-    void RemoveFromGCSet(const UObject* InObject);
-    bool IsInGCSet(const UObject* InObject);
+    /**
+     * Test if a light userdata is a descriptor handle
+     */
+    static FORCEINLINE bool IsDescHandle(const void* Handle) { return ((UPTRINT)Handle & 1) != 0; }
+
+    /**
+     * Get the descriptor referenced by a handle
+     *
+     * @return - the descriptor, or nullptr if it was released or has a different type
+     */
+    FORCEINLINE void* FindDesc(const void* Handle, EDescType type) const
+    {
+        const UPTRINT Value = (UPTRINT)Handle;
+        const int32 Index = (int32)((Value >> 1) & (((UPTRINT)1 << DESC_HANDLE_INDEX_BITS) - 1));
+        if (!(Value & 1) || Index >= DescSlots.Num())
+        {
+            return nullptr;
+        }
+        const FDescSlot& Slot = DescSlots[Index];
+        return Slot.Type == type && (UPTRINT)Slot.Generation == (Value >> (DESC_HANDLE_INDEX_BITS + 1)) ? Slot.Desc : nullptr;
+    }
+
+    /**
+     * Get the descriptor referenced by a handle and check its UObject
+     */
+    void* FindDescWithObjectCheck(const void* Handle, EDescType type) const;
 
     void AddToClassWhiteSet(const FString& ClassName);
     void RemoveFromClassWhiteSet(const FString& ClassName);
@@ -96,8 +138,16 @@ private:
     TMap<TWeakObjectPtr<UFunction>, UFunction*> OverriddenFunctions;
 #endif
 
-	TMap<void*, EDescType> DescSet;
-    TMap<const UObject*, bool> GCSet;
+    struct FDescSlot
+    {
+        void* Desc;
+        uint32 Generation;          // bumped whenever the slot is released, truncated to the bits a handle can hold
+        EDescType Type;
+    };
+
+	TMap<void*, int32> DescSet;     // descriptor -> slot index
+    TArray<FDescSlot> DescSlots;
+    TArray<int32> FreeDescSlots;
     TMap<const FString, bool> ClassWhiteSet;
 };
 
@@ -52,6 +52,11 @@ bool AUnLuaPerformanceTestProxy::Raycast(const FVector &Origin, const FVector &D
     return true;
 }
 
+FVector AUnLuaPerformanceTestProxy::MoveComponent(const FVector &Delta, const FRotator &NewRotation, float Scale, int32 MoveFlags, bool bSweep) const
+{
+    return Delta;
+}
+
 void AUnLuaPerformanceTestProxy::GetIndices(TArray<int32> &OutIndices) const
 {
 }
@@ -84,6 +89,7 @@ bool AUnLuaPerformanceTestProxy::GetMeshInfo(int32 &OutMeshID, FString &OutMeshN
 #include "Misc/DateTime.h"
 #include "Misc/FileHelper.h"
 #include "UnLuaEx.h"
+#include "LuaAllocator.h"
 
 bool LogPerformanceData(const FString &Message)
 {
@@ -94,6 +100,47 @@ bool LogPerformanceData(const FString &Message)
 
 EXPORT_FUNCTION(bool, LogPerformanceData, const FString&)
 
+/**
+ * Run a GC heavy script in a standalone Lua state, return the time of each iteration in nanoseconds
+ */
+static double RunGCHeavyScript(lua_Alloc Allocator, void *UserData, int32 N)
+{
+    static const char *Chunk = R"(
+        local Cache = {}
+        for i = 1, N do
+            local Value = { i, i + 1, Key = i }
+            local Getter = function() return Value end
+            Cache[i % 1024] = { Value, Getter, "Key" .. i }
+        end
+    )";
+
+    lua_State *L = lua_newstate(Allocator, UserData);
+    luaL_openlibs(L);
+    lua_pushinteger(L, N);
+    lua_setglobal(L, "N");
+
+    const double StartTime = FPlatformTime::Seconds();
+    if (luaL_dostring(L, Chunk) != LUA_OK)
+    {
+        UE_LOG(LogUnLua, Warning, TEXT("%s"), UTF8_TO_TCHAR(lua_tostring(L, -1)));
+    }
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    const double EndTime = FPlatformTime::Seconds();
+
+    lua_close(L);
+    return (EndTime - StartTime) * 1000000000.0 / N;
+}
+
+FString BenchmarkLuaAllocators(int32 N)
+{
+    const double DefaultTime = RunGCHeavyScript(LuaDefaultAllocator, nullptr, N);
+    FLuaSmallObjectPool Pool;
+    const double PooledTime = RunGCHeavyScript(LuaPooledAllocator, &Pool, N);
+    return FString::Printf(TEXT("GC heavy script (default allocator) ; %f\nGC heavy script (small object pool) ; %f"), DefaultTime, PooledTime);
+}
+
+EXPORT_FUNCTION(FString, BenchmarkLuaAllocators, int32)
+
 EXPORT_FUNCTION_EX(Seconds, double, FPlatformTime::Seconds)
 
 #endif
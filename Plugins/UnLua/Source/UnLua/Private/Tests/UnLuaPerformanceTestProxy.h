@@ -48,6 +48,9 @@ public:
     UFUNCTION(BlueprintCallable)
     bool Raycast(const FVector &Origin, const FVector &Direction) const;
 
+    UFUNCTION(BlueprintCallable)
+    FVector MoveComponent(const FVector &Delta, const FRotator &NewRotation, float Scale, int32 MoveFlags, bool bSweep) const;
+
     UFUNCTION(BlueprintCallable)
     void GetIndices(TArray<int32> &OutIndices) const;
 
@@ -78,6 +81,12 @@ private:
     UPROPERTY()
     FString MeshName;
 
+    UPROPERTY()
+    FName MeshTag = TEXT("StaticMesh");
+
+    UPROPERTY()
+    FText MeshDisplayName = FText::FromString(TEXT("Static Mesh"));
+
     UPROPERTY()
     FVector COM;
 
@@ -0,0 +1,143 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#include "UEObjectReferencer.h"
+#include "UnLuaPrivate.h"
+
+static const int32 MinFreeSlotsToCompact = 1024;
+
+void FObjectReferencer::AddObjectRef(UObject *Object)
+{
+    if (!Object)
+    {
+        return;
+    }
+
+    FEntry &Entry = Entries.FindOrAdd(Object, FEntry{ INDEX_NONE, 0, false });
+    if (Entry.RefCount++ > 0)
+    {
+        return;
+    }
+
+    if (FreeSlots.Num() > 0)
+    {
+        Entry.Slot = FreeSlots.Pop(false);
+        Objects[Entry.Slot] = Object;
+    }
+    else
+    {
+        Entry.Slot = Objects.Add(Object);
+    }
+    INC_DWORD_STAT(STAT_UnLua_ReferencedObjects);
+}
+
+void FObjectReferencer::RemoveObjectRef(UObject *Object)
+{
+    FEntry *Entry = Entries.Find(Object);
+    if (Entry && Entry->RefCount > 0 && --Entry->RefCount == 0)
+    {
+        ReleaseSlot(*Entry);
+        if (!Entry->bCollectedByLua)
+        {
+            Entries.Remove(Object);
+        }
+    }
+}
+
+void FObjectReferencer::RemoveAllObjectRefs(UObject *Object)
+{
+    FEntry *Entry = Entries.Find(Object);
+    if (Entry && Entry->RefCount > 0)
+    {
+        Entry->RefCount = 0;
+        ReleaseSlot(*Entry);
+    }
+}
+
+void FObjectReferencer::FlushPendingReleases()
+{
+    for (const FPendingRelease &Release : PendingReleases)
+    {
+        FEntry &Entry = Entries.FindOrAdd(Release.Object, FEntry{ INDEX_NONE, 0, false });
+        Entry.bCollectedByLua = true;
+        if (Release.bHasRef && Entry.RefCount > 0 && --Entry.RefCount == 0)
+        {
+            ReleaseSlot(Entry);
+        }
+    }
+    PendingReleases.Reset();
+
+    if (FreeSlots.Num() > MinFreeSlotsToCompact && FreeSlots.Num() > Objects.Num() / 2)
+    {
+        Compact();
+    }
+}
+
+bool FObjectReferencer::NotifyUObjectDeleted(const UObjectBase *Object)
+{
+    if (PendingReleases.Num() > 0)
+    {
+        FlushPendingReleases();         // the queue mustn't outlive the objects in it
+    }
+
+    FEntry Entry;
+    if (!Entries.RemoveAndCopyValue(Object, Entry))
+    {
+        return false;
+    }
+    ReleaseSlot(Entry);
+    return Entry.bCollectedByLua;
+}
+
+void FObjectReferencer::Cleanup()
+{
+    Entries.Empty();
+    Objects.Empty();
+    FreeSlots.Empty();
+    PendingReleases.Empty();
+
+    SET_DWORD_STAT(STAT_UnLua_ReferencedObjects, 0);
+}
+
+/**
+ * Move the live references to the front, a UE GC walks 'Objects' as a whole
+ */
+void FObjectReferencer::Compact()
+{
+    TArray<UObject*> OldObjects = MoveTemp(Objects);
+    Objects.Reset();
+    FreeSlots.Reset();
+    for (TMap<const UObjectBase*, FEntry>::TIterator It(Entries); It; ++It)
+    {
+        FEntry &Entry = It.Value();
+        if (Entry.Slot != INDEX_NONE)
+        {
+            Entry.Slot = Objects.Add(OldObjects[Entry.Slot]);       // UE GC may have cleared the reference of a pending kill object
+        }
+    }
+}
+
+void FObjectReferencer::ReleaseSlot(FEntry &Entry)
+{
+    if (Entry.Slot == INDEX_NONE)
+    {
+        return;
+    }
+
+    Objects[Entry.Slot] = nullptr;
+    FreeSlots.Add(Entry.Slot);
+    Entry.Slot = INDEX_NONE;
+    DEC_DWORD_STAT(STAT_UnLua_ReferencedObjects);
+}
@@ -14,10 +14,18 @@
 
 #pragma once
 
-#include "Containers/Set.h"
+#include "Containers/Map.h"
 #include "UObject/GCObject.h"
 
-class FObjectReferencer : public FGCObject
+/**
+ * Strong references of UObjects held by Lua, and the objects whose Lua userdata were collected by Lua GC.
+ *
+ * Referenced objects live in a dense array with a free list, so a UE GC only walks the live references. An object has
+ * a reference count, one per userdata created with a reference (see AddUserdataObjectRef) plus one per bound instance.
+ * Userdata finalizers run in the middle of Lua GC, their releases are queued and applied in a batch after Lua GC steps
+ * and before UE GC.
+ */
+class UNLUA_API FObjectReferencer : public FGCObject
 {
 public:
     static FObjectReferencer& Instance()
@@ -26,21 +34,48 @@ public:
         return Referencer;
     }
 
-    void AddObjectRef(UObject *Object)
-    {
-        ReferencedObjects.Add(Object);
-    }
+    /**
+     * Add a strong reference of an object
+     */
+    void AddObjectRef(UObject *Object);
 
-    void RemoveObjectRef(UObject *Object)
-    {
-        ReferencedObjects.Remove(Object);
-    }
+    /**
+     * Release a strong reference of an object immediately
+     */
+    void RemoveObjectRef(UObject *Object);
 
-    void Cleanup()
+    /**
+     * Drop all strong references of an object immediately, e.g. the actor is destroyed
+     */
+    void RemoveAllObjectRefs(UObject *Object);
+
+    /**
+     * Called by the finalizer of a userdata of the object, the object is marked as collected by Lua and the reference
+     * of the userdata is released in the next batch
+     *
+     * @param bHasRef - whether the userdata holds a strong reference
+     */
+    void NotifyUserdataCollected(UObject *Object, bool bHasRef)
     {
-        return ReferencedObjects.Empty();
+        PendingReleases.Add(FPendingRelease{ Object, bHasRef });
     }
 
+    /**
+     * Apply the queued releases of collected userdata
+     */
+    void FlushPendingReleases();
+
+    /**
+     * Forget a deleted object
+     *
+     * @return - whether a userdata of the object has been collected by Lua
+     */
+    bool NotifyUObjectDeleted(const UObjectBase *Object);
+
+    void Cleanup();
+
+    FORCEINLINE int32 GetNumReferencedObjects() const { return Objects.Num() - FreeSlots.Num(); }
+
 #if UE_BUILD_DEBUG
     void Debug()
     {
@@ -50,7 +85,7 @@ public:
 
     virtual void AddReferencedObjects(FReferenceCollector& Collector) override
     {
-        Collector.AddReferencedObjects(ReferencedObjects);
+        Collector.AddReferencedObjects(Objects);            // free slots are null
     }
 
     virtual FString GetReferencerName() const
@@ -61,7 +96,26 @@ public:
 private:
     FObjectReferencer() {}
 
-    TSet<UObject*> ReferencedObjects;
+    struct FEntry
+    {
+        int32 Slot;                     // index in 'Objects', INDEX_NONE if not referenced
+        int32 RefCount;
+        bool bCollectedByLua;
+    };
+
+    struct FPendingRelease
+    {
+        UObject *Object;
+        bool bHasRef;
+    };
+
+    void ReleaseSlot(FEntry &Entry);
+    void Compact();
+
+    TMap<const UObjectBase*, FEntry> Entries;
+    TArray<UObject*> Objects;
+    TArray<int32> FreeSlots;
+    TArray<FPendingRelease> PendingReleases;
 };
 
 #define GObjectReferencer FObjectReferencer::Instance()
@@ -18,8 +18,26 @@
 #include "LuaContext.h"
 
 DEFINE_STAT(STAT_UnLua_Lua_Memory);
+DEFINE_STAT(STAT_UnLua_LuaPool_Memory);
 DEFINE_STAT(STAT_UnLua_PersistentParamBuffer_Memory);
 DEFINE_STAT(STAT_UnLua_OutParmRec_Memory);
+DEFINE_STAT(STAT_UnLua_ParamBufferArena_Memory);
+DEFINE_STAT(STAT_UnLua_ParamBuffer_HeapAllocs);
+DEFINE_STAT(STAT_UnLua_GetField_SlowPath);
+DEFINE_STAT(STAT_UnLua_LoadModule);
+DEFINE_STAT(STAT_UnLua_Coroutine_Live);
+DEFINE_STAT(STAT_UnLua_Coroutine_Pooled);
+DEFINE_STAT(STAT_UnLua_Coroutine_Resumes);
+DEFINE_STAT(STAT_UnLua_Coroutine_PoolHits);
+DEFINE_STAT(STAT_UnLua_Coroutine_ScheduledResumes);
+DEFINE_STAT(STAT_UnLua_Coroutine_Deferred);
+DEFINE_STAT(STAT_UnLua_Coroutine_Tick);
+DEFINE_STAT(STAT_UnLua_GC_Tick);
+DEFINE_STAT(STAT_UnLua_GC_Cycles);
+DEFINE_STAT(STAT_UnLua_GC_AllocationRate);
+DEFINE_STAT(STAT_UnLua_ReferencedObjects);
+DEFINE_STAT(STAT_UnLua_BindCandidates);
+DEFINE_STAT(STAT_UnLua_BindBatch);
 
 namespace UnLua
 {
@@ -19,6 +19,8 @@
 #include "Containers/LuaSet.h"
 #include "Containers/LuaMap.h"
 #include "ReflectionUtils/ReflectionRegistry.h"
+#include "LuaBytecodeCache.h"
+#include "LuaScriptArchive.h"
 #include "Misc/Paths.h"
 #include "Misc/FileHelper.h"
 
@@ -58,11 +60,22 @@ namespace UnLua
         return GLuaCxt->ExportEnum(Enum);
     }
 
-    lua_State* CreateState()
+    void SetEagerClassRegistration(const UStruct *Struct, bool bEager)
+    {
+        FLuaContext::Create();
+        GLuaCxt->SetEagerClassRegistration(Struct, bEager);
+    }
+
+    uint32 GetNumFieldSlowPathHits()
+    {
+        return GLuaCxt ? GLuaCxt->GetNumFieldSlowPathHits() : 0;
+    }
+
+    lua_State* CreateState(ELuaAllocator Allocator)
     {
         if (GLuaCxt)
         {
-            GLuaCxt->CreateState();
+            GLuaCxt->CreateState(Allocator);
             return *GLuaCxt;
         }
         return nullptr;
@@ -96,6 +109,18 @@ namespace UnLua
      */
     bool LoadFile(lua_State *L, const FString &RelativeFilePath, const char *Mode, int32 Env)
     {
+        // hot fixed scripts downloaded to 'ProjectPersistentDownloadDir' override the archive
+        if (GLuaScriptArchive.IsMounted() && !FUnLuaDelegates::LoadLuaFile.IsBound() && GetDownloadedFilePath(RelativeFilePath).IsEmpty())
+        {
+            FTCHARToUTF8 ChunkName(*RelativeFilePath);
+            const char *Chunk = nullptr;
+            int32 ChunkSize = 0;
+            if (GLuaScriptArchive.Find(ChunkName.Get(), ChunkName.Length(), Chunk, ChunkSize))
+            {
+                return LoadChunk(L, Chunk, ChunkSize, ChunkName.Get(), Mode, Env);      // loads the script in archive as a Lua chunk
+            }
+        }
+
         FString FullFilePath = GetFullPathFromRelativePath(RelativeFilePath);
         if (FullFilePath.IsEmpty())
         {
@@ -118,7 +143,8 @@ namespace UnLua
         }
 
         int32 SkipLen = (3 < Data.Num()) && (0xEF == Data[0]) && (0xBB == Data[1]) && (0xBF == Data[2]) ? 3 : 0;        // skip UTF-8 BOM mark
-        return LoadChunk(L, (const char*)(Data.GetData() + SkipLen), Data.Num() - SkipLen, TCHAR_TO_UTF8(*RelativeFilePath), Mode, Env);    // loads the buffer as a Lua chunk
+        bool bCacheBytecode = !FUnLuaDelegates::LoadLuaFile.IsBound();         // never write bytecode of sources provided (maybe decrypted) by developers
+        return LoadChunk(L, (const char*)(Data.GetData() + SkipLen), Data.Num() - SkipLen, TCHAR_TO_UTF8(*RelativeFilePath), Mode, Env, bCacheBytecode);    // loads the buffer as a Lua chunk
     }
 
     /**
@@ -146,9 +172,10 @@ namespace UnLua
     /**
      * Load a Lua chunk without running it
      */
-    bool LoadChunk(lua_State *L, const char *Chunk, int32 ChunkSize, const char *ChunkName, const char *Mode, int32 Env)
+    bool LoadChunk(lua_State *L, const char *Chunk, int32 ChunkSize, const char *ChunkName, const char *Mode, int32 Env, bool bCacheBytecode)
     {
-        int32 Code = luaL_loadbufferx(L, Chunk, ChunkSize, ChunkName, Mode);        // loads the buffer as a Lua chunk
+        // loads the buffer as a Lua chunk
+        int32 Code = bCacheBytecode ? GLuaBytecodeCache.Load(L, Chunk, ChunkSize, ChunkName, Mode) : luaL_loadbufferx(L, Chunk, ChunkSize, ChunkName, Mode);
         if (Code != LUA_OK)
         {
             UE_LOG(LogUnLua, Warning, TEXT("Failed to call luaL_loadbufferx, error code: %d"), Code);
@@ -176,6 +203,26 @@ namespace UnLua
         return Code == LUA_OK;
     }
 
+    bool MountScriptArchive(const FString &FilePath)
+    {
+        return GLuaScriptArchive.Mount(FilePath);
+    }
+
+    void UnmountScriptArchive()
+    {
+        GLuaScriptArchive.Unmount();
+    }
+
+    const TMap<FString, FModuleLoadStats>& GetModuleLoadStats()
+    {
+        return GLuaBytecodeCache.GetModuleLoadStats();
+    }
+
+    void DumpModuleLoadStats()
+    {
+        GLuaBytecodeCache.DumpModuleLoadStats();
+    }
+
     /**
      * Run a Lua chunk
      */
@@ -248,7 +295,7 @@ namespace UnLua
         if (!bAlwaysCreate)
         {
             // find the pointer from 'StructMap' first
-            lua_getfield(L, LUA_REGISTRYINDEX, "StructMap");
+            PushRegistryTable(L, ERegistryTable::StructMap);
             lua_pushlightuserdata(L, Value);
             int32 Type = lua_rawget(L, -2);
             if (Type == LUA_TUSERDATA)
@@ -355,29 +402,203 @@ namespace UnLua
             lua_pushnil(L);
             return 1;
         }
+        return PushUObjectFast(L, Object, bAddRef);
+    }
+
+    /**
+     * Push a UObject without validating it
+     */
+    int32 PushUObjectFast(lua_State *L, UObjectBaseUtility *Object, bool bAddRef)
+    {
+        check(Object);
 
-        lua_getfield(L, LUA_REGISTRYINDEX, "ObjectMap");
-        lua_pushlightuserdata(L, Object);
-        int32 Type = lua_rawget(L, -2);     // find the object from 'ObjectMap' first
+        PushRegistryTable(L, ERegistryTable::ObjectMap);
+        int32 Type = lua_rawgetp(L, -1, Object);        // find the object from 'ObjectMap' first
         if (Type == LUA_TNIL)
         {
             // 1. create a new userdata for the object if it's not found; 2. cache it in 'ObjectMap'
             lua_pop(L, 1);
             PushObjectCore(L, Object);
-            lua_pushlightuserdata(L, Object);
-            lua_pushvalue(L, -2);
-            lua_rawset(L, -4);
+            lua_pushvalue(L, -1);
+            lua_rawsetp(L, -3, Object);
 
             if (bAddRef && !Object->IsNative())
             {
-                GObjectReferencer.AddObjectRef((UObject*)Object);       // add a reference for the object if it's a non-native object
+                AddUserdataObjectRef(L, Object);                        // add a reference for the object if it's a non-native object
             }
+            GLuaCxt->IncNumPushUObjectMisses();
+        }
+        else
+        {
+            GLuaCxt->IncNumPushUObjectHits();
         }
         lua_remove(L, -2);
 
         return 1;
     }
 
+    void GetPushUObjectStats(uint32 &OutNumHits, uint32 &OutNumMisses)
+    {
+        OutNumHits = GLuaCxt ? GLuaCxt->GetNumPushUObjectHits() : 0;
+        OutNumMisses = GLuaCxt ? GLuaCxt->GetNumPushUObjectMisses() : 0;
+    }
+
+    bool ResumeCoroutine(lua_State *Thread, int32 NumArgs)
+    {
+        if (!GLuaCxt || !Thread)
+        {
+            return false;
+        }
+        FLuaCoroutineScheduler &Scheduler = GLuaCxt->GetCoroutineScheduler();
+        const int32 Handle = Scheduler.Find(Thread);
+        return Handle != LUA_REFNIL && Scheduler.Resume(Handle, NumArgs);
+    }
+
+    FCoroutineStats GetCoroutineStats()
+    {
+        FCoroutineStats Stats;
+        if (GLuaCxt)
+        {
+            const FLuaCoroutineScheduler &Scheduler = GLuaCxt->GetCoroutineScheduler();
+            Stats.NumLiveCoroutines = Scheduler.GetNumLiveCoroutines();
+            Stats.NumPooledThreads = Scheduler.GetNumPooledThreads();
+            Stats.NumResumes = Scheduler.GetNumResumes();
+            Stats.NumPoolHits = Scheduler.GetNumPoolHits();
+            Stats.NumPoolMisses = Scheduler.GetNumPoolMisses();
+            Stats.NumReadyCoroutines = Scheduler.GetNumReadyCoroutines();
+            Stats.NumSleepingCoroutines = Scheduler.GetNumSleepingCoroutines();
+            Stats.NumScheduledResumesLastFrame = Scheduler.GetNumScheduledResumesLastFrame();
+            Stats.NumDeferredLastFrame = Scheduler.GetNumDeferredLastFrame();
+            Stats.FrameBudget = Scheduler.GetFrameBudget();
+        }
+        return Stats;
+    }
+
+    void SetCoroutineFrameBudget(float Milliseconds)
+    {
+        if (GLuaCxt)
+        {
+            GLuaCxt->GetCoroutineScheduler().SetFrameBudget(Milliseconds);
+        }
+    }
+
+    void TickCoroutines(float DeltaTime)
+    {
+        if (GLuaCxt && GLuaCxt->IsEnable())
+        {
+            GLuaCxt->GetCoroutineScheduler().Tick(DeltaTime);
+        }
+    }
+
+    void SetGCFrameBudget(float Milliseconds)
+    {
+        if (GLuaCxt)
+        {
+            GLuaCxt->GetGCController().SetFrameBudget(Milliseconds);
+        }
+    }
+
+    void SetGCStepAfterEngineGC(bool bEnable)
+    {
+        if (GLuaCxt)
+        {
+            GLuaCxt->GetGCController().SetStepAfterEngineGC(bEnable);
+        }
+    }
+
+    bool StepGC(float Milliseconds)
+    {
+        return GLuaCxt && GLuaCxt->GetGCController().Step(Milliseconds);
+    }
+
+    FGCStats GetGCStats()
+    {
+        FGCStats Stats;
+        if (GLuaCxt)
+        {
+            const FLuaGCController &Controller = GLuaCxt->GetGCController();
+            Stats.bEnabled = Controller.IsEnabled();
+            Stats.bDraining = Controller.IsDraining();
+            Stats.NumCycles = Controller.GetNumCycles();
+            Stats.NumStepsLastFrame = Controller.GetNumStepsLastFrame();
+            Stats.PendingWork = Controller.GetPendingWork();
+            Stats.AllocationRate = Controller.GetAllocationRate();
+            Stats.FrameBudget = Controller.GetFrameBudget();
+        }
+        return Stats;
+    }
+
+    int32 PushFString(lua_State *L, const FString &Str)
+    {
+        const int32 Len = Str.Len();
+        const TCHAR *Chars = *Str;
+        TArray<ANSICHAR, TInlineAllocator<256>> Buffer;
+        Buffer.SetNumUninitialized(Len);
+        for (int32 i = 0; i < Len; ++i)
+        {
+            if ((uint32)Chars[i] > 0x7F)
+            {
+                FTCHARToUTF8 Utf8(Chars, Len);          // not 7-bit, generic conversion
+                lua_pushlstring(L, Utf8.Get(), Utf8.Length());
+                return 1;
+            }
+            Buffer[i] = (ANSICHAR)Chars[i];
+        }
+        lua_pushlstring(L, Buffer.GetData(), Len);
+        return 1;
+    }
+
+    int32 PushFName(lua_State *L, FName Name)
+    {
+        // numbered names (i.e. 'Actor_1234' of every spawned actor) are not cached, they would stay in the cache forever
+        if (Name.GetNumber() != NAME_NO_NUMBER_INTERNAL)
+        {
+            return PushFString(L, Name.ToString());
+        }
+
+        // names with the same display index always have the same string
+#if ENGINE_MAJOR_VERSION > 4 || (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION > 22)
+        const lua_Integer Key = (lua_Integer)Name.GetDisplayIndex().ToUnstableInt();
+#else
+        const lua_Integer Key = (lua_Integer)Name.GetDisplayIndex();
+#endif
+        PushRegistryTable(L, ERegistryTable::NameCache);
+        if (lua_rawgeti(L, -1, Key) != LUA_TSTRING)
+        {
+            lua_pop(L, 1);
+            PushFString(L, Name.ToString());
+            lua_pushvalue(L, -1);
+            lua_rawseti(L, -3, Key);                    // keep the interned Lua string alive
+        }
+        lua_remove(L, -2);
+        return 1;
+    }
+
+    FString GetFString(lua_State *L, int32 Index)
+    {
+        size_t Len = 0;
+        const char *Str = lua_tolstring(L, Index, &Len);
+        if (!Str || Len == 0)
+        {
+            return FString();
+        }
+
+        FString Result;
+        TArray<TCHAR> &Chars = Result.GetCharArray();
+        Chars.SetNumUninitialized((int32)Len + 1);
+        for (int32 i = 0; i < (int32)Len; ++i)
+        {
+            if ((uint8)Str[i] > 0x7F)
+            {
+                FUTF8ToTCHAR Conv(Str, (int32)Len);     // not 7-bit, generic conversion
+                return FString(Conv.Length(), Conv.Get());
+            }
+            Chars[i] = (TCHAR)Str[i];
+        }
+        Chars[Len] = TEXT('\0');
+        return Result;
+    }
+
     /**
      * Get a UObject at the given stack index
      */
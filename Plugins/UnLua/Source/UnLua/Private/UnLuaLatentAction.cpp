@@ -24,7 +24,7 @@ void UUnLuaLatentAction::OnCompleted(int32 InLinkage) const
 
 FLatentActionInfo UUnLuaLatentAction::CreateInfo(const int32 Linkage)
 {
-    return FLatentActionInfo(Linkage, GetTypeHash(FGuid::NewGuid()), TEXT("OnCompleted"), this);
+    return FLatentActionInfo(Linkage, FLuaCoroutineScheduler::NewLatentUUID(), TEXT("OnCompleted"), this);
 }
 
 FLatentActionInfo UUnLuaLatentAction::CreateInfoForLegacy()
@@ -67,5 +67,5 @@ TStatId UUnLuaLatentAction::GetStatId() const
 void UUnLuaLatentAction::OnLegacyCallback(int32 InLinkage)
 {
     Callback.Unbind();
-    GLuaCxt->ResumeThread(InLinkage);
+    GLuaCxt->GetCoroutineScheduler().Resume(InLinkage);
 }
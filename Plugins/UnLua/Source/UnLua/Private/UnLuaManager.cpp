@@ -74,89 +74,173 @@ bool UUnLuaManager::Bind(UObjectBaseUtility *Object, UClass *Class, const TCHAR
     UE_LOG(LogUnLua, Log, TEXT("UUnLuaManager::Bind : %p,%s,%s"), Object, *Object->GetName(),InModuleName);
 #endif
     
-    bool bSuccess = true;
+    lua_State *L = *GLuaCxt;
+
+    // the metatable of the class is unregistered once all its instances are gone, so check it for every instance
+    FClassDesc *ClassDesc = GReflectionRegistry.FindClass(Class);
+    if (!ClassDesc || ClassDesc->GetMetatableRef() == LUA_NOREF)
+    {
+        if (!RegisterClass(L, Class))              // register class first
+        {
+            return false;
+        }
+    }
+
+    // class level binding, done once per class
+    const FBoundClass *BoundClass = BoundClasses.Find(Class);
+    if (!BoundClass || BoundClass->Class.Get() != Class || !BoundClass->ModuleName.Equals(InModuleName, ESearchCase::CaseSensitive))
+    {
+        FString Error;
+        if (!BindClass(Class, InModuleName, Error))
+        {
+            UE_LOG(LogUnLua, Warning, TEXT("Failed to attach %s module for object %s,%p!\n%s"), InModuleName, *Object->GetName(), Object, *Error);
+            return false;
+        }
+        BoundClass = &BoundClasses.FindChecked(Class);
+    }
+
+    // copy the cached prototype, 'Initialize' may bind other classes and invalidate 'BoundClass'
+    const int32 ModuleRef = BoundClass->ModuleRef;
+    const int32 InitializeRef = BoundClass->InitializeRef;
+    const int32 NumFields = BoundClass->NumFields;
+
+    // instance level binding
+    bool bDerivedClassBinded = false;
+    if (Object->GetClass() != Class)
+    {
+        bDerivedClassBinded = true;
+        OnDerivedClassBinded(Object->GetClass(), Class);
+    }
+
+    // create a Lua instance for this UObject
+    int32 ObjectRef = NewLuaObject(L, Object, ModuleRef, NumFields);
+
+    AddAttachedObject(Object, ObjectRef);                                       // record this binded UObject
+
+    // try call user first user function handler
+    bool bResult = false;
+    if (InitializeRef != LUA_NOREF && PushFunction(L, Object, InitializeRef))  // push the resolved Lua function 'Initialize'
+    {
+        if (InitializerTableRef != INDEX_NONE)
+        {
+            lua_rawgeti(L, LUA_REGISTRYINDEX, InitializerTableRef);             // push a initializer table if necessary
+        }
+        else
+        {
+            lua_pushnil(L);
+        }
+        bResult = ::CallFunction(L, 2, 0);                                 // call 'Initialize'
+        if (!bResult)
+        {
+            UE_LOG(LogUnLua, Warning, TEXT("Failed to call 'Initialize' function!"));
+        }
+    }
+
+    // the first initialized instance tells how large the next instances of this class should be presized
+    if (NumFields < 0 && ObjectRef != LUA_REFNIL)
+    {
+        int32 Count = 0;
+        lua_rawgeti(L, LUA_REGISTRYINDEX, ObjectRef);
+        lua_pushnil(L);
+        while (lua_next(L, -2) != 0)
+        {
+            ++Count;
+            lua_pop(L, 1);
+        }
+        lua_pop(L, 1);
+
+        FBoundClass *BoundClassToUpdate = BoundClasses.Find(Class);
+        if (BoundClassToUpdate && BoundClassToUpdate->ModuleRef == ModuleRef)
+        {
+            BoundClassToUpdate->NumFields = Count;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Class level binding: require the Lua module, collect the Lua functions and the overridable UFunctions, and override them
+ */
+bool UUnLuaManager::BindClass(UClass *Class, const FString &InModuleName, FString &Error)
+{
     lua_State *L = *GLuaCxt;
 
     bool bMultipleLuaBind = false;
     UClass** BindedClass = Classes.Find(InModuleName);
     if ((BindedClass)
-        &&(*BindedClass != Object->GetClass()))
+        &&(*BindedClass != Class))
     {
         bMultipleLuaBind = true;
     }
 
-    if (!RegisterClass(L, Class))              // register class first
-    {
-        return false;
-    }
-
     // try bind lua if not bind or use a copyed table
-    UnLua::FLuaRetValues RetValues = UnLua::Call(L, "require", TCHAR_TO_UTF8(InModuleName));    // require Lua module
-    FString Error;
+    UnLua::FLuaRetValues RetValues = UnLua::Call(L, "require", TCHAR_TO_UTF8(*InModuleName));    // require Lua module
     if (!RetValues.IsValid() || RetValues.Num() == 0)
     {
         Error = "invalid return value of require()";
-        bSuccess = false;
+        return false;
     }
-    else if (RetValues[0].GetType() != LUA_TTABLE)
+    if (RetValues[0].GetType() != LUA_TTABLE)
     {
         Error = FString("table needed but got ");
         if(RetValues[0].GetType() == LUA_TSTRING)
             Error += UTF8_TO_TCHAR(RetValues[0].Value<const char*>());
         else
             Error += UTF8_TO_TCHAR(lua_typename(L, RetValues[0].GetType()));
-        bSuccess = false;
+        return false;
     }
-    else
+
+    if (!BindInternal(Class, InModuleName, true, bMultipleLuaBind, Error))                           // bind!!!
     {
-        bSuccess = BindInternal(Object, Class, InModuleName, true, bMultipleLuaBind, Error);                             // bind!!!
+        return false;
     }
 
-    if (bSuccess)
-    {   
-        bool bDerivedClassBinded = false;
-        if (Object->GetClass() != Class)
-        {
-            bDerivedClassBinded = true;
-            OnDerivedClassBinded(Object->GetClass(), Class);
-        }
-
-        FString RealModuleName = *ModuleNames.Find(Class);
-
-        GLuaCxt->AddModuleName(*RealModuleName);                                       // record this required module
-
-        // create a Lua instance for this UObject
-        int32 ObjectRef = NewLuaObject(L, Object, bDerivedClassBinded ? Class : nullptr, TCHAR_TO_UTF8(*RealModuleName));
-
-        AddAttachedObject(Object, ObjectRef);                                       // record this binded UObject
+    const FString &RealModuleName = ModuleNames.FindChecked(Class);
+    GLuaCxt->AddModuleName(*RealModuleName);                                      // record this required module
 
-        // try call user first user function handler
-        bool bResult = false;
-        int32 FunctionRef = PushFunction(L, Object, "Initialize");                  // push hard coded Lua function 'Initialize'
-        if (FunctionRef != INDEX_NONE)
+    // cache the prototype of the instances: the module and its resolved 'Initialize'
+    FBoundClass BoundClass{ FWeakObjectPtr(Class), InModuleName, LUA_NOREF, LUA_NOREF, -1 };
+    GetLoadedModule(L, TCHAR_TO_UTF8(*RealModuleName));
+    lua_pushvalue(L, -1);
+    BoundClass.ModuleRef = luaL_ref(L, LUA_REGISTRYINDEX);
+    int32 N = 1;
+    while (lua_istable(L, -1))
+    {
+        lua_pushstring(L, "Initialize");
+        if (lua_rawget(L, -2) == LUA_TFUNCTION)
         {
-            if (InitializerTableRef != INDEX_NONE)
-            {
-                lua_rawgeti(L, LUA_REGISTRYINDEX, InitializerTableRef);             // push a initializer table if necessary
-            }
-            else
-            {
-                lua_pushnil(L);
-            }
-            bResult = ::CallFunction(L, 2, 0);                                 // call 'Initialize'
-            if (!bResult)
-            {
-                UE_LOG(LogUnLua, Warning, TEXT("Failed to call 'Initialize' function!"));
-            }
-            luaL_unref(L, LUA_REGISTRYINDEX, FunctionRef);
+            BoundClass.InitializeRef = luaL_ref(L, LUA_REGISTRYINDEX);
+            break;
         }
+        lua_pop(L, 1);
+        lua_pushstring(L, "Super");
+        lua_rawget(L, -2);
+        ++N;
     }
-    else
+    lua_pop(L, N);
+
+    FBoundClass OldBoundClass;
+    if (BoundClasses.RemoveAndCopyValue(Class, OldBoundClass))
     {
-        UE_LOG(LogUnLua, Warning, TEXT("Failed to attach %s module for object %s,%p!\n%s"), InModuleName, *Object->GetName(), Object, *Error);
+        ReleaseBoundClass(OldBoundClass);
     }
+    BoundClasses.Add(Class, BoundClass);
+    return true;
+}
 
-    return bSuccess;
+/**
+ * Release the Lua references held by a class level binding
+ */
+void UUnLuaManager::ReleaseBoundClass(const FBoundClass &BoundClass)
+{
+    lua_State *L = *GLuaCxt;
+    if (!L)
+    {
+        return;
+    }
+    luaL_unref(L, LUA_REGISTRYINDEX, BoundClass.ModuleRef);
+    luaL_unref(L, LUA_REGISTRYINDEX, BoundClass.InitializeRef);
 }
 
 /**
@@ -164,6 +248,16 @@ bool UUnLuaManager::Bind(UObjectBaseUtility *Object, UClass *Class, const TCHAR
  */
 bool UUnLuaManager::OnModuleHotfixed(const TCHAR *InModuleName)
 {
+    // the next instances of classes bound to this module redo the class level binding
+    for (TMap<UClass*, FBoundClass>::TIterator It(BoundClasses); It; ++It)
+    {
+        if (It.Value().ModuleName.Equals(InModuleName, ESearchCase::CaseSensitive))
+        {
+            ReleaseBoundClass(It.Value());
+            It.RemoveCurrent();
+        }
+    }
+
     TArray<FString> _ModuleNames;
     _ModuleNames.Add(InModuleName);
     int16* NameIdx = RealModuleNames.Find(InModuleName);
@@ -235,6 +329,7 @@ void UUnLuaManager::Cleanup(UWorld *InWorld, bool bFullCleanup)
     AttachedObjects.Empty();
     AttachedActors.Empty();
 
+    BoundClasses.Empty();
     ModuleNames.Empty();
     Classes.Empty();
     OverridableFunctions.Empty();
@@ -265,6 +360,11 @@ void UUnLuaManager::CleanUpByClass(UClass *Class)
 
     FString ModuleName = *ModuleNamePtr;
 
+    FBoundClass BoundClass;
+    if (BoundClasses.RemoveAndCopyValue(Class, BoundClass))
+    {
+        ReleaseBoundClass(BoundClass);
+    }
     Classes.Remove(ModuleName);
     ModuleFunctions.Remove(ModuleName);
 
@@ -581,7 +681,7 @@ void UUnLuaManager::OnActorDestroyed(AActor *Actor)
  */
 void UUnLuaManager::OnLatentActionCompleted(int32 LinkID)
 {
-    GLuaCxt->ResumeThread(LinkID);              // resume a coroutine
+    GLuaCxt->GetCoroutineScheduler().Resume(LinkID);              // resume a coroutine
 }
 
 /**
@@ -629,9 +729,9 @@ UClass* UUnLuaManager::GetTargetClass(UClass *Class, UFunction **GetModuleNameFu
 /**
  * Bind a Lua module for a UObject
  */
-bool UUnLuaManager::BindInternal(UObjectBaseUtility* Object, UClass* Class, const FString& InModuleName, bool bNewCreated, bool bMultipleLuaBind, FString& Error)
+bool UUnLuaManager::BindInternal(UClass* Class, const FString& InModuleName, bool bNewCreated, bool bMultipleLuaBind, FString& Error)
 {
-    if (!Object || !Class)
+    if (!Class)
     {
         return false;
     }
@@ -1082,17 +1182,20 @@ void UUnLuaManager::AddAttachedObject(UObjectBaseUtility *Object, int32 ObjectRe
 void UUnLuaManager::ReleaseAttachedObjectLuaRef(UObjectBaseUtility* Object)
 {
     check(Object);
-    
-    GObjectReferencer.RemoveObjectRef((UObject*)Object);
-    
-    int32* ObjectLuaRef = AttachedObjects.Find(Object);
-    if ((ObjectLuaRef)
-        &&(*ObjectLuaRef != LUA_REFNIL))
+
+    int32 ObjectLuaRef = LUA_REFNIL;
+    if (!AttachedObjects.RemoveAndCopyValue(Object, ObjectLuaRef))
+    {
+        return;                                                 // released already
+    }
+
+    GObjectReferencer.RemoveObjectRef((UObject*)Object);        // the reference added by 'AddAttachedObject'
+
+    if (ObjectLuaRef != LUA_REFNIL)
     {   
 #if UNLUA_ENABLE_DEBUG != 0
-        UE_LOG(LogUnLua, Log, TEXT("ReleaseAttachedObjectLuaRef : %s,%p,%d"), *Object->GetName(), Object, *ObjectLuaRef);
+        UE_LOG(LogUnLua, Log, TEXT("ReleaseAttachedObjectLuaRef : %s,%p,%d"), *Object->GetName(), Object, ObjectLuaRef);
 #endif
-        luaL_unref(UnLua::GetState(), LUA_REGISTRYINDEX, *ObjectLuaRef);
-        AttachedObjects.Remove(Object);
+        luaL_unref(UnLua::GetState(), LUA_REGISTRYINDEX, ObjectLuaRef);
     }
 }
@@ -82,7 +82,8 @@ private:
 
     UClass* GetTargetClass(UClass *Class, UFunction **GetModuleNameFunc = nullptr);
 
-    bool BindInternal(UObjectBaseUtility *Object, UClass *Class, const FString &InModuleName, bool bNewCreated, bool bMultipleLuaBind, FString &Error);
+    bool BindClass(UClass *Class, const FString &InModuleName, FString &Error);
+    bool BindInternal(UClass *Class, const FString &InModuleName, bool bNewCreated, bool bMultipleLuaBind, FString &Error);
     bool ConditionalUpdateClass(UClass *Class, const TSet<FName> &LuaFunctions, TMap<FName, UFunction*> &UEFunctions);
 
     void OverrideFunctions(const TSet<FName> &LuaFunctions, TMap<FName, UFunction*> &UEFunctions, UClass *OuterClass, bool bCheckFuncNetMode = false);
@@ -131,6 +132,19 @@ private:
     TSet<FName> DefaultActionNames;
     TArray<FKey> AllKeys;
 
+    struct FBoundClass
+    {
+        FWeakObjectPtr Class;               // detects a deleted class whose address is reused
+        FString ModuleName;                 // module name passed to 'Bind'
+        int32 ModuleRef;                    // reference of the required module, the prototype of the instances
+        int32 InitializeRef;                // reference of the resolved 'Initialize' function, or LUA_NOREF
+        int32 NumFields;                    // number of fields of an initialized instance, -1 if no instance yet
+    };
+
+    TMap<UClass*, FBoundClass> BoundClasses;    // classes whose class level binding is done
+
+    void ReleaseBoundClass(const FBoundClass &BoundClass);
+
     TMap<UObjectBaseUtility*, int32> AttachedObjects;
     TSet<AActor*> AttachedActors;
 
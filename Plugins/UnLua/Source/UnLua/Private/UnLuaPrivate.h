@@ -44,8 +44,26 @@
 #if STATS
 DECLARE_STATS_GROUP(TEXT("UnLua"), STATGROUP_UnLua, STATCAT_Advanced);
 DECLARE_MEMORY_STAT_EXTERN(TEXT("Lua Memory"), STAT_UnLua_Lua_Memory, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Lua Small Object Pool Memory"), STAT_UnLua_LuaPool_Memory, STATGROUP_UnLua, /*UNLUA_API*/);
 DECLARE_MEMORY_STAT_EXTERN(TEXT("Persistent Parameter Buffer Memory"), STAT_UnLua_PersistentParamBuffer_Memory, STATGROUP_UnLua, /*UNLUA_API*/);
 DECLARE_MEMORY_STAT_EXTERN(TEXT("OutParmRec Memory"), STAT_UnLua_OutParmRec_Memory, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Parameter Buffer Arena Memory"), STAT_UnLua_ParamBufferArena_Memory, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Parameter Buffer Heap Allocations"), STAT_UnLua_ParamBuffer_HeapAllocs, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Lua Module"), STAT_UnLua_LoadModule, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Field Lookup Slow Path"), STAT_UnLua_GetField_SlowPath, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Coroutines"), STAT_UnLua_Coroutine_Live, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pooled Coroutine Threads"), STAT_UnLua_Coroutine_Pooled, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Coroutine Resumes"), STAT_UnLua_Coroutine_Resumes, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Coroutine Pool Hits"), STAT_UnLua_Coroutine_PoolHits, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Scheduled Coroutine Resumes"), STAT_UnLua_Coroutine_ScheduledResumes, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Deferred Coroutines"), STAT_UnLua_Coroutine_Deferred, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tick Coroutines"), STAT_UnLua_Coroutine_Tick, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Lua GC Step"), STAT_UnLua_GC_Tick, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Lua GC Cycles"), STAT_UnLua_GC_Cycles, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Lua Allocation Rate (KB/s)"), STAT_UnLua_GC_AllocationRate, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("UObjects Referenced by Lua"), STAT_UnLua_ReferencedObjects, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Async Loaded Binding Candidates"), STAT_UnLua_BindCandidates, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bind Batch"), STAT_UnLua_BindBatch, STATGROUP_UnLua, /*UNLUA_API*/);
 #endif
 
 UNLUA_API bool HotfixLua();
@@ -29,6 +29,10 @@
 #define SUPPORTS_RPC_CALL 0
 #endif
 
+#ifndef UNLUA_ENABLE_BYTECODE_CACHE
+#define UNLUA_ENABLE_BYTECODE_CACHE 0
+#endif
+
 UNLUA_API DECLARE_LOG_CATEGORY_EXTERN(LogUnLua, Log, All);
 UNLUA_API DECLARE_LOG_CATEGORY_EXTERN(UnLuaDelegate, Log, All);
 
@@ -41,6 +45,55 @@ struct luaL_Reg;
 
 namespace UnLua
 {   
+    /**
+     * Memory allocator of the Lua VM. the state created by UnLua itself uses 'SmallObjectPool' if
+     * UNLUA_USE_SMALL_OBJECT_POOL is enabled in UnLua.Build.cs
+     */
+    enum class ELuaAllocator : uint8
+    {
+        Default,                // FMemory only
+        SmallObjectPool,        // size-classed pool for blocks up to 256 bytes in front of FMemory
+    };
+
+    /**
+     * Load statistics of a Lua script file
+     */
+    struct FModuleLoadStats
+    {
+        double LoadTime = 0.0;              // seconds spent in the last load (parsing, or loading bytecode)
+        int32 SourceSize = 0;
+        int32 NumLoads = 0;
+        bool bFromBytecodeCache = false;    // whether the last load hit the bytecode cache
+    };
+
+    /**
+     * Statistics of the coroutines resumed from C++ (latent functions, UnLua_StartCoroutine)
+     */
+    struct FCoroutineStats
+    {
+        int32 NumLiveCoroutines = 0;        // registered coroutines waiting to be resumed
+        int32 NumPooledThreads = 0;         // finished threads kept for reuse
+        uint32 NumResumes = 0;
+        uint32 NumPoolHits = 0;
+        uint32 NumPoolMisses = 0;
+        int32 NumReadyCoroutines = 0;       // coroutines waiting for the next frame
+        int32 NumSleepingCoroutines = 0;    // coroutines waiting in UnLua_WaitSeconds
+        int32 NumScheduledResumesLastFrame = 0;
+        int32 NumDeferredLastFrame = 0;     // coroutines pushed to the next frame by the frame budget
+        float FrameBudget = 0.0f;           // milliseconds
+    };
+
+    struct FGCStats
+    {
+        bool bEnabled = false;              // Lua GC is stepped every frame by UnLua
+        bool bDraining = false;             // collecting the garbage of a cleaned up world
+        uint32 NumCycles = 0;               // GC cycles finished by UnLua's steps
+        int32 NumStepsLastFrame = 0;
+        int32 PendingWork = 0;              // KB of work carried over to the next frames
+        float AllocationRate = 0.0f;        // KB per second
+        float FrameBudget = 0.0f;           // milliseconds
+    };
+
     //!!!Fix!!!
 
     /**
@@ -185,13 +238,30 @@ namespace UnLua
      */
     UNLUA_API bool ExportEnum(IExportedEnum *Enum);
 
+    /**
+     * Populate the metatable of a class with all its reflected properties and functions when the class is registered,
+     * instead of on first access. subclasses inherit the setting
+     *
+     * @param Struct - the UClass or UScriptStruct
+     * @param bEager - true to populate eagerly, false to restore lazy lookup
+     */
+    UNLUA_API void SetEagerClassRegistration(const UStruct *Struct, bool bEager = true);
+
+    /**
+     * Get the number of field lookups that missed the class metatables and went through reflection
+     *
+     * @return - the number of slow path hits since start up
+     */
+    UNLUA_API uint32 GetNumFieldSlowPathHits();
+
 
     /**
      * Create Lua state
      *
+     * @param Allocator - memory allocator of the Lua VM, ignored if the state already exists
      * @return - created Lua state
      */
-    UNLUA_API lua_State* CreateState();
+    UNLUA_API lua_State* CreateState(ELuaAllocator Allocator = ELuaAllocator::Default);
 
     /**
      * @return - Lua state
@@ -238,9 +308,37 @@ namespace UnLua
      * @param ChunkName - name of the chunk, which is used for error messages and in debug information
      * @param Mode - mode of the chunk, it may be the string "b" (only binary chunks), "t" (only text chunks), or "bt" (both binary and text)
      * @param Env - Lua stack index of the 'Env'
+     * @param bCacheBytecode - whether to go through the bytecode cache, the chunk name must identify the source file
      * @return - true if Lua chunk is loaded successfully, false otherwise
      */
-    UNLUA_API bool LoadChunk(lua_State *L, const char *Chunk, int32 ChunkSize, const char *ChunkName = "", const char *Mode = "bt", int32 Env = 0);
+    UNLUA_API bool LoadChunk(lua_State *L, const char *Chunk, int32 ChunkSize, const char *ChunkName = "", const char *Mode = "bt", int32 Env = 0, bool bCacheBytecode = false);
+
+    /**
+     * Mount a packed Lua script archive, 'require' and LoadFile look it up before the script directory. scripts
+     * downloaded to the persistent download dir still override the archive.
+     * the archive in the script directory (UnLuaScripts.ulpk) is mounted automatically in non-editor builds
+     *
+     * @param FilePath - full path of the archive
+     * @return - true if the archive is mounted successfully, false otherwise
+     */
+    UNLUA_API bool MountScriptArchive(const FString &FilePath);
+
+    /**
+     * Unmount the Lua script archive, scripts are loaded from the file system again
+     */
+    UNLUA_API void UnmountScriptArchive();
+
+    /**
+     * Get load statistics of Lua script files
+     *
+     * @return - chunk name -> load statistics
+     */
+    UNLUA_API const TMap<FString, FModuleLoadStats>& GetModuleLoadStats();
+
+    /**
+     * Log load statistics of Lua script files, slowest first
+     */
+    UNLUA_API void DumpModuleLoadStats();
 
     /**
      * Run a Lua chunk
@@ -285,6 +383,103 @@ namespace UnLua
      */
     UNLUA_API int32 PushUObject(lua_State *L, UObjectBaseUtility *Object, bool bAddRef = true);
 
+    /**
+     * Push a UObject which is known to be valid, e.g. 'this' of a native call. it skips the validity check of 'PushUObject'
+     *
+     * @param Object - a valid UObject instance
+     * @param bAddRef - whether to add reference for this object
+     * @return - the number of results on Lua stack
+     */
+    UNLUA_API int32 PushUObjectFast(lua_State *L, UObjectBaseUtility *Object, bool bAddRef = true);
+
+    /**
+     * Get how often pushed UObjects were found in the object cache
+     *
+     * @param[out] OutNumHits - the number of pushes served from the cache since start up
+     * @param[out] OutNumMisses - the number of pushes which created a new userdata since start up
+     */
+    UNLUA_API void GetPushUObjectStats(uint32 &OutNumHits, uint32 &OutNumMisses);
+
+    /**
+     * Resume a coroutine registered for resuming from C++, i.e. waiting for a latent function or started by UnLua_StartCoroutine
+     *
+     * @param Thread - the coroutine
+     * @param NumArgs - number of arguments on the top of the coroutine's stack
+     * @return - whether the coroutine is still alive, false if it finished or isn't registered
+     */
+    UNLUA_API bool ResumeCoroutine(lua_State *Thread, int32 NumArgs = 0);
+
+    /**
+     * Get statistics of the coroutines resumed from C++
+     */
+    UNLUA_API FCoroutineStats GetCoroutineStats();
+
+    /**
+     * Set the time budget for resuming scheduled coroutines in a frame, at least one coroutine is resumed per frame
+     *
+     * @param Milliseconds - the budget, 0 or negative means unlimited
+     */
+    UNLUA_API void SetCoroutineFrameBudget(float Milliseconds);
+
+    /**
+     * Resume the coroutines waiting for a frame or sleeping time manually. It's called by UnLua when a world starts ticking,
+     * calling it explicitly is only needed when no world ticks
+     *
+     * @param DeltaTime - game time elapsed since last tick, in seconds
+     */
+    UNLUA_API void TickCoroutines(float DeltaTime);
+
+    /**
+     * Set the time budget of Lua GC steps per frame. Set it to 0 or less before the Lua state is created to keep the Lua GC
+     * configuration of previous versions (generational mode, full collections on world cleanup).
+     *
+     * @param Milliseconds - the budget
+     */
+    UNLUA_API void SetGCFrameBudget(float Milliseconds);
+
+    /**
+     * Also step Lua GC within the frame budget right after UE's GC
+     */
+    UNLUA_API void SetGCStepAfterEngineGC(bool bEnable);
+
+    /**
+     * Step Lua GC for a time budget regardless of the allocations, e.g. on a loading screen
+     *
+     * @param Milliseconds - the budget
+     * @return - whether a GC cycle finished
+     */
+    UNLUA_API bool StepGC(float Milliseconds);
+
+    /**
+     * Get statistics of the Lua GC steps driven by UnLua
+     */
+    UNLUA_API FGCStats GetGCStats();
+
+    /**
+     * Push a FString as a UTF-8 Lua string, strings of 7-bit characters skip the generic conversion
+     *
+     * @param Str - the string
+     * @return - the number of results on Lua stack
+     */
+    UNLUA_API int32 PushFString(lua_State *L, const FString &Str);
+
+    /**
+     * Push a FName as a Lua string. Lua strings of names without a number are cached, so pushing the same name again
+     * doesn't convert or allocate
+     *
+     * @param Name - the name
+     * @return - the number of results on Lua stack
+     */
+    UNLUA_API int32 PushFName(lua_State *L, FName Name);
+
+    /**
+     * Get a FString at the given stack index, strings of 7-bit characters skip the generic conversion
+     *
+     * @param Index - Lua stack index
+     * @return - the string, empty if the value isn't a string or a number
+     */
+    UNLUA_API FString GetFString(lua_State *L, int32 Index);
+
     /**
      * Get a UObject at the given stack index
      *
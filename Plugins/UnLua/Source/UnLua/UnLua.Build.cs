@@ -131,6 +131,26 @@ public class UnLua : ModuleRules
             PublicDefinitions.Add("ENABLE_TYPE_CHECK=0");
         }
 
+        bool bEnableBytecodeCache = false;          // cache misses are written to Saved/UnLua/BytecodeCache on the game thread
+        if (bEnableBytecodeCache)
+        {
+            PublicDefinitions.Add("UNLUA_ENABLE_BYTECODE_CACHE=1");
+        }
+        else
+        {
+            PublicDefinitions.Add("UNLUA_ENABLE_BYTECODE_CACHE=0");
+        }
+
+        bool bUseSmallObjectPool = false;
+        if (bUseSmallObjectPool)
+        {
+            PublicDefinitions.Add("UNLUA_USE_SMALL_OBJECT_POOL=1");
+        }
+        else
+        {
+            PublicDefinitions.Add("UNLUA_USE_SMALL_OBJECT_POOL=0");
+        }
+
         bool bEnableDebug = false;
         if (bEnableDebug)
         {
@@ -0,0 +1,34 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#include "Commandlets/Commandlet.h"
+#include "UnLuaScriptArchiveCommandlet.generated.h"
+
+/**
+ * Pack Lua scripts into an archive (see FLuaScriptArchive)
+ *
+ * -Source=<dir>    script directory, 'Content/Script' by default
+ * -Output=<file>   the archive, 'Content/Script/UnLuaScripts.ulpk' by default
+ * -Bytecode        pack precompiled bytecode instead of sources, it must match the Lua build of the target platform
+ * -Strip           strip debug information from bytecode
+ */
+UCLASS()
+class UUnLuaScriptArchiveCommandlet : public UCommandlet
+{
+    GENERATED_UCLASS_BODY()
+
+public:
+    virtual int32 Main(const FString& Params) override;
+};
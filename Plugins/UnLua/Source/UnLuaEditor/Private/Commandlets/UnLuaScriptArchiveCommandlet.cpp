@@ -0,0 +1,108 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#include "Commandlets/UnLuaScriptArchiveCommandlet.h"
+#include "LuaScriptArchive.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "lua.hpp"
+
+static int WriteBytecode(lua_State *L, const void *Data, size_t Size, void *UserData)
+{
+    ((TArray<uint8>*)UserData)->Append((const uint8*)Data, Size);
+    return 0;
+}
+
+UUnLuaScriptArchiveCommandlet::UUnLuaScriptArchiveCommandlet(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer)
+{
+}
+
+int32 UUnLuaScriptArchiveCommandlet::Main(const FString &Params)
+{
+    FString SourceDir = GLuaSrcFullPath;
+    FParse::Value(*Params, TEXT("Source="), SourceDir);
+    FString OutputPath = FLuaScriptArchive::GetDefaultPath();
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+    const bool bBytecode = FParse::Param(*Params, TEXT("Bytecode"));
+    const bool bStrip = FParse::Param(*Params, TEXT("Strip"));
+
+    SourceDir = FPaths::ConvertRelativePathToFull(SourceDir);
+    if (!SourceDir.EndsWith(TEXT("/")))
+    {
+        SourceDir.Append(TEXT("/"));
+    }
+
+    TArray<FString> Files;
+    IFileManager::Get().FindFilesRecursive(Files, *SourceDir, TEXT("*.lua"), true, false);
+
+    lua_State *L = bBytecode ? luaL_newstate() : nullptr;
+    TArray<FString> Names;
+    TArray<TArray<uint8>> Scripts;
+    int32 NumErrors = 0;
+    for (const FString &File : Files)
+    {
+        FString Name = File;
+        FPaths::MakePathRelativeTo(Name, *SourceDir);
+
+        TArray<uint8> Data;
+        if (!FFileHelper::LoadFileToArray(Data, *File))
+        {
+            UE_LOG(LogUnLua, Error, TEXT("Failed to read %s"), *File);
+            ++NumErrors;
+            continue;
+        }
+
+        if ((3 < Data.Num()) && (0xEF == Data[0]) && (0xBB == Data[1]) && (0xBF == Data[2]))
+        {
+            Data.RemoveAt(0, 3);                // skip UTF-8 BOM mark
+        }
+
+        if (L)
+        {
+            FTCHARToUTF8 ChunkName(*Name);
+            if (luaL_loadbufferx(L, (const char*)Data.GetData(), Data.Num(), ChunkName.Get(), "t") != LUA_OK)
+            {
+                UE_LOG(LogUnLua, Error, TEXT("Failed to compile %s : %s"), *File, UTF8_TO_TCHAR(lua_tostring(L, -1)));
+                lua_pop(L, 1);
+                ++NumErrors;
+                continue;
+            }
+            Data.Reset();
+            lua_dump(L, WriteBytecode, &Data, bStrip ? 1 : 0);
+            lua_pop(L, 1);
+        }
+
+        Names.Add(Name);
+        Scripts.Add(MoveTemp(Data));
+    }
+
+    if (L)
+    {
+        lua_close(L);
+    }
+
+    TArray<uint8> Archive;
+    FLuaScriptArchive::Build(Names, Scripts, Archive);
+    if (!FFileHelper::SaveArrayToFile(Archive, *OutputPath))
+    {
+        UE_LOG(LogUnLua, Error, TEXT("Failed to write Lua script archive %s"), *OutputPath);
+        return 1;
+    }
+
+    UE_LOG(LogUnLua, Display, TEXT("%d scripts (%s) packed into %s, %d bytes, %d errors"), Names.Num(), bBytecode ? TEXT("bytecode") : TEXT("source"), *OutputPath, Archive.Num(), NumErrors);
+    return NumErrors > 0 ? 1 : 0;
+}
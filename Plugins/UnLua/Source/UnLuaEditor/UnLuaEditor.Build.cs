@@ -65,6 +65,7 @@ public class UnLuaEditor : ModuleRules
                 "UMG",
                 "Slate",
                 "SlateCore",
+                "Lua",
                 "UnLua"
             }
         );
@@ -0,0 +1,87 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#include "UnLua.h"
+#include "LuaAllocator.h"
+#include "Misc/AutomationTest.h"
+#include "UnLuaTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(FLuaAllocatorSpec, "UnLua.API.LuaAllocator", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+END_DEFINE_SPEC(FLuaAllocatorSpec)
+
+void FLuaAllocatorSpec::Define()
+{
+    Describe(TEXT("FLuaSmallObjectPool"), [this]()
+    {
+        It(TEXT("释放的块被同尺寸级别的分配复用"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            FLuaSmallObjectPool Pool;
+            void* Block = Pool.Alloc(40);
+            Pool.Free(Block, 40);
+            TEST_TRUE(Pool.Alloc(48) == Block);
+            TEST_TRUE(Pool.Alloc(40) != Block);
+        });
+
+        It(TEXT("页内的块全部释放后页被归还，每个尺寸级别最多保留一页"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            FLuaSmallObjectPool Pool;
+            TArray<void*> Blocks;
+            for (int32 i = 0; i < FLuaSmallObjectPool::PageSize / 64 * 3; ++i)
+            {
+                Blocks.Add(Pool.Alloc(64));
+            }
+            TEST_TRUE(Pool.GetNumPages() > 3);
+
+            for (void* Block : Blocks)
+            {
+                Pool.Free(Block, 64);
+            }
+            TEST_EQUAL(Pool.GetNumPages(), 1);
+        });
+
+        It(TEXT("超过256字节的块不进入对象池"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            TEST_TRUE(FLuaSmallObjectPool::IsPooled(1));
+            TEST_TRUE(FLuaSmallObjectPool::IsPooled(256));
+            TEST_FALSE(FLuaSmallObjectPool::IsPooled(257));
+            TEST_FALSE(FLuaSmallObjectPool::IsPooled(0));
+        });
+    });
+
+    Describe(TEXT("LuaPooledAllocator"), [this]()
+    {
+        It(TEXT("使用对象池分配器的Lua虚拟机可以正常运行"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            FLuaSmallObjectPool Pool;
+            lua_State* L = lua_newstate(LuaPooledAllocator, &Pool);
+            luaL_openlibs(L);
+            const auto Chunk = R"(
+            local Items = {}
+            for i = 1, 10000 do
+                Items[i] = { Index = i, Name = "Item" .. i }
+            end
+            Result = #Items + Items[9527].Index
+            )";
+            TEST_EQUAL(luaL_dostring(L, Chunk), LUA_OK);
+            lua_getglobal(L, "Result");
+            TEST_EQUAL(lua_tointeger(L, -1), 19527LL);
+            lua_close(L);
+        });
+    });
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,167 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#include "UnLua.h"
+#include "LuaContext.h"
+#include "Async/Async.h"
+#include "Misc/AutomationTest.h"
+#include "UnLuaTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(FLuaContextSpec, "UnLua.API.LuaContext", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+    lua_State* L;
+    TArray<UUnLuaTestStub*> Stubs;
+
+    void AddCandidates(const TArray<UUnLuaTestStub*>& Objects)
+    {
+        // candidates are queued when they are created off the game thread
+        Async(EAsyncExecution::Thread, [&Objects]()
+        {
+            for (UUnLuaTestStub* Object : Objects)
+            {
+                GLuaCxt->TryToBindLua(Object);
+            }
+        }).Wait();
+    }
+END_DEFINE_SPEC(FLuaContextSpec)
+
+void FLuaContextSpec::Define()
+{
+    BeforeEach([this]()
+    {
+        UnLua::Startup();
+        L = UnLua::CreateState();
+        GLuaCxt->ProcessBindBatch(false);
+        for (int32 i = 0; i < UNLUA_BIND_BATCH_MAX_OBJECTS * 2 + 1; ++i)
+        {
+            Stubs.Add(NewObject<UUnLuaTestStub>());
+        }
+    });
+
+    AfterEach([this]()
+    {
+        Stubs.Empty();
+        UnLua::Shutdown();
+    });
+
+    Describe(TEXT("Bind batch"), [this]()
+    {
+        It(TEXT("重复进入队列的对象只处理一次"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            Stubs[0]->SetFlags(RF_NeedPostLoad);
+            AddCandidates({ Stubs[0], Stubs[0] });
+            GLuaCxt->ProcessBindBatch(false);
+            TEST_EQUAL(GLuaCxt->GetNumBindCandidates(), 1);
+
+            Stubs[0]->ClearFlags(RF_NeedPostLoad);
+            GLuaCxt->ProcessBindBatch(false);
+            TEST_EQUAL(GLuaCxt->GetNumBindCandidates(), 0);
+        });
+
+        It(TEXT("未加载完的对象移到队尾，不阻塞后面的对象"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            Stubs[0]->SetFlags(RF_NeedPostLoad);
+            Stubs[2]->SetFlags(RF_NeedPostLoad);
+            AddCandidates({ Stubs[0], Stubs[1], Stubs[2], Stubs[3] });
+            GLuaCxt->ProcessBindBatch(false);
+            TEST_EQUAL(GLuaCxt->GetNumBindCandidates(), 2);
+
+            Stubs[2]->ClearFlags(RF_NeedPostLoad);
+            GLuaCxt->ProcessBindBatch(false);
+            TEST_EQUAL(GLuaCxt->GetNumBindCandidates(), 1);
+
+            Stubs[0]->ClearFlags(RF_NeedPostLoad);
+            GLuaCxt->ProcessBindBatch(false);
+            TEST_EQUAL(GLuaCxt->GetNumBindCandidates(), 0);
+        });
+
+        It(TEXT("Tick每次最多绑定UNLUA_BIND_BATCH_MAX_OBJECTS个对象，Flush全部绑定"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            AddCandidates(Stubs);
+            GLuaCxt->ProcessBindBatch(true);
+            const int32 NumLeft = GLuaCxt->GetNumBindCandidates();
+            if (UNLUA_BIND_BATCH_BUDGET_MS > 0.0f)
+            {
+                TEST_TRUE(NumLeft >= Stubs.Num() - UNLUA_BIND_BATCH_MAX_OBJECTS);
+                GLuaCxt->ProcessBindBatch(true);
+                TEST_TRUE(GLuaCxt->GetNumBindCandidates() < NumLeft);
+            }
+
+            GLuaCxt->ProcessBindBatch(false);
+            TEST_EQUAL(GLuaCxt->GetNumBindCandidates(), 0);
+        });
+
+        It(TEXT("绑定时重入批量处理不会越界，每个对象只绑定一次"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            // the module flushes the bind batch during binding, like a blocking load does
+            lua_register(L, "ProcessBindBatch", [](lua_State*) -> int { GLuaCxt->ProcessBindBatch(false); return 0; });
+            const char* Chunk = "\
+            NumBound = 0\
+            Bound = {}\
+            package.preload.UnLuaTestBindStub = function()\
+                local M = {}\
+                function M:Initialize()\
+                    NumBound = NumBound + 1\
+                    Bound[self] = (Bound[self] or 0) + 1\
+                    ProcessBindBatch()\
+                end\
+                return M\
+            end\
+            ";
+            UnLua::RunChunk(L, Chunk);
+
+            TArray<UUnLuaTestBindStub*> BindStubs;
+            for (int32 i = 0; i < 8; ++i)
+            {
+                BindStubs.Add(NewObject<UUnLuaTestBindStub>());
+            }
+            Stubs[0]->SetFlags(RF_NeedPostLoad);
+            Async(EAsyncExecution::Thread, [&BindStubs, this]()
+            {
+                GLuaCxt->TryToBindLua(Stubs[0]);
+                for (UUnLuaTestBindStub* Object : BindStubs)
+                {
+                    GLuaCxt->TryToBindLua(Object);
+                }
+            }).Wait();
+
+            GLuaCxt->ProcessBindBatch(false);
+            TEST_EQUAL(GLuaCxt->GetNumBindCandidates(), 1);
+            Stubs[0]->ClearFlags(RF_NeedPostLoad);
+
+            UnLua::RunChunk(L, "\
+            local NumObjects = 0\
+            for _, Count in pairs(Bound) do\
+                if Count ~= 1 then return -1 end\
+                NumObjects = NumObjects + 1\
+            end\
+            return NumObjects == NumBound and NumBound or -1\
+            ");
+            TEST_EQUAL(lua_tointeger(L, -1), (lua_Integer)BindStubs.Num());
+        });
+
+        It(TEXT("游戏线程中创建的对象立即绑定，不进入队列"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            Stubs[0]->SetFlags(RF_NeedPostLoad);
+            GLuaCxt->TryToBindLua(Stubs[0]);
+            GLuaCxt->ProcessBindBatch(false);
+            TEST_EQUAL(GLuaCxt->GetNumBindCandidates(), 0);
+            Stubs[0]->ClearFlags(RF_NeedPostLoad);
+        });
+    });
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,225 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#include "UnLua.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(FLuaCoroutineSchedulerSpec, "UnLua.API.CoroutineScheduler", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+    lua_State* L;
+END_DEFINE_SPEC(FLuaCoroutineSchedulerSpec)
+
+void FLuaCoroutineSchedulerSpec::Define()
+{
+    BeforeEach([this]
+    {
+        UnLua::Startup();
+        L = UnLua::CreateState();
+    });
+
+    Describe(TEXT("UnLua_StartCoroutine"), [this]
+    {
+        It(TEXT("在协程中立即执行函数，执行完毕返回false"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Result\
+            local bAlive = UnLua_StartCoroutine(function(A, B)\
+                Result = A + B\
+            end, 1, 2)\
+            return bAlive, Result\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tointeger(L, -1), 3LL);
+            TEST_FALSE(lua_toboolean(L, -2));
+        });
+
+        It(TEXT("执行完毕的协程线程被复用"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const UnLua::FCoroutineStats OldStats = UnLua::GetCoroutineStats();
+            const char* Chunk = "\
+            local Threads = {}\
+            for i = 1, 2 do\
+                UnLua_StartCoroutine(function() Threads[i] = coroutine.running() end)\
+            end\
+            return Threads[1] == Threads[2]\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_TRUE(lua_toboolean(L, -1));
+            const UnLua::FCoroutineStats Stats = UnLua::GetCoroutineStats();
+            TEST_EQUAL(Stats.NumPoolHits, OldStats.NumPoolHits + 1);
+            TEST_EQUAL(Stats.NumLiveCoroutines, 0);
+            TEST_EQUAL(Stats.NumPooledThreads, 1);
+        });
+
+        It(TEXT("挂起的协程可以从C++恢复，执行完毕后不能再恢复"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            Step = 0\
+            UnLua_StartCoroutine(function()\
+                Co = coroutine.running()\
+                coroutine.yield()\
+                Step = 1\
+            end)\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            lua_getglobal(L, "Co");
+            lua_State* Thread = lua_tothread(L, -1);
+            lua_pop(L, 1);
+            TEST_TRUE(Thread != nullptr);
+            TEST_EQUAL(UnLua::GetCoroutineStats().NumLiveCoroutines, 1);
+
+            TEST_FALSE(UnLua::ResumeCoroutine(Thread));
+            lua_getglobal(L, "Step");
+            TEST_EQUAL(lua_tointeger(L, -1), 1LL);
+            TEST_EQUAL(UnLua::GetCoroutineStats().NumLiveCoroutines, 0);
+            TEST_FALSE(UnLua::ResumeCoroutine(Thread));
+        });
+    });
+
+    Describe(TEXT("帧调度"), [this]
+    {
+        It(TEXT("coroutine.yield挂起的协程在下一帧恢复"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            Step = 0\
+            UnLua_StartCoroutine(function()\
+                for i = 1, 2 do\
+                    coroutine.yield()\
+                    Step = i\
+                end\
+            end)\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(UnLua::GetCoroutineStats().NumReadyCoroutines, 1);
+
+            UnLua::TickCoroutines(0.016f);
+            lua_getglobal(L, "Step");
+            TEST_EQUAL(lua_tointeger(L, -1), 1LL);
+            lua_pop(L, 1);
+
+            UnLua::TickCoroutines(0.016f);
+            lua_getglobal(L, "Step");
+            TEST_EQUAL(lua_tointeger(L, -1), 2LL);
+            lua_pop(L, 1);
+            TEST_EQUAL(UnLua::GetCoroutineStats().NumLiveCoroutines, 0);
+        });
+
+        It(TEXT("Lua创建的协程等待latent函数后普通挂起，交还给Lua恢复"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, "UnLuaTest");
+            UnLua::PushUObject(L, World, false);
+            lua_setglobal(L, "World");
+
+            const char* Chunk = "\
+            Step = 0\
+            Co = coroutine.create(function()\
+                UE.UKismetSystemLibrary.Delay(World, 10)\
+                Step = 1\
+                coroutine.yield()\
+                Step = 2\
+            end)\
+            coroutine.resume(Co)\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            lua_getglobal(L, "Co");
+            lua_State* Thread = lua_tothread(L, -1);
+            lua_pop(L, 1);
+            TEST_EQUAL(UnLua::GetCoroutineStats().NumLiveCoroutines, 1);
+
+            TEST_TRUE(UnLua::ResumeCoroutine(Thread));          // the latent action completes
+            UnLua::FCoroutineStats Stats = UnLua::GetCoroutineStats();
+            TEST_EQUAL(Stats.NumLiveCoroutines, 0);
+            TEST_EQUAL(Stats.NumReadyCoroutines, 0);
+
+            UnLua::TickCoroutines(0.016f);
+            lua_getglobal(L, "Step");
+            TEST_EQUAL(lua_tointeger(L, -1), 1LL);
+            lua_pop(L, 1);
+
+            UnLua::RunChunk(L, "coroutine.resume(Co)");
+            lua_getglobal(L, "Step");
+            TEST_EQUAL(lua_tointeger(L, -1), 2LL);
+            lua_pop(L, 1);
+
+            World->DestroyWorld(false);
+        });
+
+        It(TEXT("UnLua_WaitSeconds在累计时间足够后恢复"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            bWoken = false\
+            UnLua_StartCoroutine(function()\
+                UnLua_WaitSeconds(0.5)\
+                bWoken = true\
+            end)\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(UnLua::GetCoroutineStats().NumSleepingCoroutines, 1);
+
+            UnLua::TickCoroutines(0.3f);
+            lua_getglobal(L, "bWoken");
+            TEST_FALSE(lua_toboolean(L, -1));
+            lua_pop(L, 1);
+
+            UnLua::TickCoroutines(0.3f);
+            lua_getglobal(L, "bWoken");
+            TEST_TRUE(lua_toboolean(L, -1));
+            lua_pop(L, 1);
+            TEST_EQUAL(UnLua::GetCoroutineStats().NumSleepingCoroutines, 0);
+        });
+
+        It(TEXT("超出帧预算的协程推迟到下一帧，每帧至少恢复一个"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const float OldBudget = UnLua::GetCoroutineStats().FrameBudget;
+            UnLua::SetCoroutineFrameBudget(0.001f);
+            const char* Chunk = "\
+            Count = 0\
+            for i = 1, 3 do\
+                UnLua_StartCoroutine(function()\
+                    coroutine.yield()\
+                    local Start = os.clock()\
+                    while os.clock() - Start < 0.002 do end\
+                    Count = Count + 1\
+                end)\
+            end\
+            ";
+            UnLua::RunChunk(L, Chunk);
+
+            UnLua::TickCoroutines(0.016f);
+            lua_getglobal(L, "Count");
+            TEST_EQUAL(lua_tointeger(L, -1), 1LL);
+            lua_pop(L, 1);
+            UnLua::FCoroutineStats Stats = UnLua::GetCoroutineStats();
+            TEST_EQUAL(Stats.NumScheduledResumesLastFrame, 1);
+            TEST_EQUAL(Stats.NumDeferredLastFrame, 2);
+
+            UnLua::TickCoroutines(0.016f);
+            UnLua::TickCoroutines(0.016f);
+            lua_getglobal(L, "Count");
+            TEST_EQUAL(lua_tointeger(L, -1), 3LL);
+            lua_pop(L, 1);
+            UnLua::SetCoroutineFrameBudget(OldBudget);
+        });
+    });
+
+    AfterEach([this]
+    {
+        UnLua::Shutdown();
+    });
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
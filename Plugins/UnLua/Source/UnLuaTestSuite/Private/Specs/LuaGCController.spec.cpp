@@ -0,0 +1,68 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#include "UnLua.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(FLuaGCControllerSpec, "UnLua.API.GCController", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+    lua_State* L;
+END_DEFINE_SPEC(FLuaGCControllerSpec)
+
+void FLuaGCControllerSpec::Define()
+{
+    BeforeEach([this]
+    {
+        UnLua::Startup();
+        L = UnLua::CreateState();
+    });
+
+    Describe(TEXT("StepGC"), [this]
+    {
+        It(TEXT("默认由UnLua分步执行增量GC"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            TEST_TRUE(UnLua::GetGCStats().bEnabled);
+            UnLua::RunChunk(L, "return collectgarbage('isrunning')");
+            TEST_TRUE(lua_toboolean(L, -1));
+        });
+
+        It(TEXT("分步执行GC直到回收垃圾对象"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const uint32 OldNumCycles = UnLua::GetGCStats().NumCycles;
+            const char* Chunk = "\
+            bCollected = false\
+            setmetatable({}, {__gc = function() bCollected = true end})\
+            ";
+            UnLua::RunChunk(L, Chunk);
+
+            for (int32 i = 0; i < 3; ++i)
+            {
+                UnLua::StepGC(100.0f);
+            }
+            lua_getglobal(L, "bCollected");
+            TEST_TRUE(lua_toboolean(L, -1));
+            lua_pop(L, 1);
+            TEST_TRUE(UnLua::GetGCStats().NumCycles > OldNumCycles);
+        });
+    });
+
+    AfterEach([this]
+    {
+        UnLua::Shutdown();
+    });
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -580,6 +580,178 @@ void FUnLuaLibArraySpec::Define()
             TEST_EQUAL(lua_tointeger(L, -1), 2LL);
             TEST_EQUAL(lua_tointeger(L, -2), 1LL);
         });
+
+        It(TEXT("将TArray<float>/TArray<bool>内容转为LuaTable"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Floats = UE.TArray(0.0)\
+            Floats:Add(0.5)\
+            Floats:Add(1.5)\
+            local Bools = UE.TArray(true)\
+            Bools:Add(false)\
+            Bools:Add(true)\
+            local A, B = Floats:ToTable(), Bools:ToTable()\
+            return #A, A[1], A[2], B[1], B[2]\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_TRUE(lua_toboolean(L, -1));
+            TEST_FALSE(lua_toboolean(L, -2));
+            TEST_EQUAL(lua_tonumber(L, -3), 1.5);
+            TEST_EQUAL(lua_tonumber(L, -4), 0.5);
+            TEST_EQUAL(lua_tointeger(L, -5), 2LL);
+        });
+    });
+
+    Describe(TEXT("FromTable"), [this]
+    {
+        It(TEXT("用LuaTable的内容替换数组内容"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Array = UE.TArray(0)\
+            Array:Add(7)\
+            Array:FromTable({1, 2, 3})\
+            return Array\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            const TArray<int32>* Array = (TArray<int32>*)UnLua::GetArray(L, -1);
+            TEST_TRUE(Array!=nullptr);
+            TEST_EQUAL(Array->Num(), 3);
+            TEST_EQUAL(Array->operator[](0), 1);
+            TEST_EQUAL(Array->operator[](2), 3);
+        });
+
+        It(TEXT("Append(table)追加LuaTable的所有元素到数组末尾"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Array = UE.TArray(UE.FVector)\
+            Array:Add(UE.FVector(1, 1, 1))\
+            Array:Append({UE.FVector(2, 2, 2), UE.FVector(3, 3, 3)})\
+            return Array\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            const TArray<FVector>* Array = (TArray<FVector>*)UnLua::GetArray(L, -1);
+            TEST_TRUE(Array!=nullptr);
+            TEST_EQUAL(Array->Num(), 3);
+            TEST_EQUAL(Array->operator[](1), FVector(2, 2, 2));
+            TEST_EQUAL(Array->operator[](2), FVector(3, 3, 3));
+        });
+
+        It(TEXT("Append(table)追加LuaTable的所有字符串到数组末尾"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Array = UE.TArray('')\
+            Array:Append({'A', 'B'})\
+            return Array\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            const TArray<FString>* Array = (TArray<FString>*)UnLua::GetArray(L, -1);
+            TEST_TRUE(Array!=nullptr);
+            TEST_EQUAL(Array->Num(), 2);
+            TEST_EQUAL(Array->operator[](1), "B");
+        });
+    });
+
+    Describe(TEXT("元方法"), [this]
+    {
+        It(TEXT("#Array返回数组长度"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Array = UE.TArray(0)\
+            Array:Add(1)\
+            Array:Add(2)\
+            return #Array\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tointeger(L, -1), 2LL);
+        });
+
+        It(TEXT("Array[i]读写元素，越界读取返回nil"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Array = UE.TArray(0)\
+            Array:Add(1)\
+            Array:Add(2)\
+            Array[1] = 5\
+            Array[#Array + 1] = 6\
+            return Array, Array[1], Array[3], Array[4]\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_TRUE(lua_isnil(L, -1));
+            TEST_EQUAL(lua_tointeger(L, -2), 6LL);
+            TEST_EQUAL(lua_tointeger(L, -3), 5LL);
+            const TArray<int32>* Array = (TArray<int32>*)UnLua::GetArray(L, -4);
+            TEST_TRUE(Array!=nullptr);
+            TEST_EQUAL(Array->Num(), 3);
+            TEST_EQUAL(Array->operator[](1), 2);
+        });
+
+        It(TEXT("非整数键不能写入数组，也不会影响其他数组"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local A = UE.TArray(0)\
+            local B = UE.TArray(0)\
+            local Ok = pcall(function() A.Foo = 1 end)\
+            return Ok, B.Foo\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_TRUE(lua_isnil(L, -1));
+            TEST_FALSE(lua_toboolean(L, -2));
+        });
+
+        It(TEXT("pairs/ipairs按顺序遍历数组"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Array = UE.TArray(0)\
+            Array:Add(1)\
+            Array:Add(2)\
+            Array:Add(3)\
+            local A, B = 0, 0\
+            for i, v in pairs(Array) do A = A + i * v end\
+            for i, v in ipairs(Array) do B = B + i * v end\
+            return A, B, Array:Length()\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tointeger(L, -1), 3LL);
+            TEST_EQUAL(lua_tointeger(L, -2), 14LL);
+            TEST_EQUAL(lua_tointeger(L, -3), 14LL);
+        });
+    });
+
+    Describe(TEXT("View"), [this]
+    {
+        It(TEXT("通过View直接读写数组内存，数组扩容后仍然有效"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Array = UE.TArray(0.0)\
+            Array:Add(0.5)\
+            Array:Add(1.5)\
+            local View = Array:View()\
+            Array:FromTable({0.5, 2.5, 4.5, 6.5, 8.5, 10.5})\
+            View[2] = 3.0\
+            local Sum = 0\
+            for i, v in pairs(View) do Sum = Sum + v end\
+            return Array, #View, View[3], View[7], Sum\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tonumber(L, -1), 33.5);
+            TEST_TRUE(lua_isnil(L, -2));
+            TEST_EQUAL(lua_tonumber(L, -3), 4.5);
+            TEST_EQUAL(lua_tointeger(L, -4), 6LL);
+            const TArray<float>* Array = (TArray<float>*)UnLua::GetArray(L, -5);
+            TEST_TRUE(Array!=nullptr);
+            TEST_EQUAL(Array->operator[](1), 3.0f);
+        });
+
+        It(TEXT("非数值类型的数组不能创建View"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Array = UE.TArray('')\
+            local View = Array:View()\
+            return View == nil\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_TRUE(lua_toboolean(L, -1));
+        });
     });
 
     AfterEach([this]
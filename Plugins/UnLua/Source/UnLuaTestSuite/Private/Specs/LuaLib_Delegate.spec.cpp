@@ -61,6 +61,22 @@ void FUnLuaLibDelegateSpec::Define()
             const auto Stub = (UUnLuaTestStub*)UnLua::GetUObject(L, -1);
             TEST_FALSE(Stub->SimpleHandler.IsBound());
         });
+
+        It(TEXT("按回调解绑后可以重新绑定，只执行新的回调"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Stub = NewObject(UE.UUnLuaTestStub)\
+            local Result = 0\
+            local Callback = function() Result = Result + 1 end\
+            Stub.SimpleHandler:Bind(Stub, Callback)\
+            Stub.SimpleHandler.Unbind({Stub, Callback})\
+            Stub.SimpleHandler:Bind(Stub, function() Result = Result + 10 end)\
+            Stub.SimpleHandler:Execute()\
+            return Result\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tointeger(L, -1), 10LL);
+        });
     });
 
     Describe(TEXT("Execute"), [this]()
@@ -279,6 +279,26 @@ void FUnLuaLibMapSpec::Define()
         });
     });
 
+    Describe(TEXT("元方法"), [this]()
+    {
+        It(TEXT("#Map返回元素数量，pairs遍历所有键值对"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Map = UE.TMap(0,0)\
+            Map:Add(1,3)\
+            Map:Add(2,4)\
+            Map:Add(5,6)\
+            Map:Remove(2)\
+            local Sum = 0\
+            for k, v in pairs(Map) do Sum = Sum + k * v end\
+            return #Map, Sum\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tointeger(L, -1), 33LL);
+            TEST_EQUAL(lua_tointeger(L, -2), 2LL);
+        });
+    });
+
     AfterEach([this]
     {
         UnLua::Shutdown();
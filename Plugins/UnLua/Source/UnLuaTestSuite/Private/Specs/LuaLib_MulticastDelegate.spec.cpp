@@ -96,6 +96,109 @@ void FUnLuaLibMulticastDelegateSpec::Define()
             TEST_EQUAL(lua_tointeger(L, -1), 1LL);
             TEST_EQUAL(lua_tointeger(L, -2), 1LL);
         });
+
+        It(TEXT("不同对象的回调互不影响"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Stub1 = NewObject(UE.UUnLuaTestStub)\
+            local Stub2 = NewObject(UE.UUnLuaTestStub)\
+            local Counter1 = 0\
+            local Counter2 = 0\
+            Stub1.SimpleEvent:Add(Stub1, function() Counter1 = Counter1 + 1 end)\
+            Stub2.SimpleEvent:Add(Stub2, function() Counter2 = Counter2 + 10 end)\
+            Stub1.SimpleEvent:Broadcast()\
+            Stub2.SimpleEvent:Broadcast()\
+            Stub2.SimpleEvent:Broadcast()\
+            return Counter1, Counter2\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tointeger(L, -1), 20LL);
+            TEST_EQUAL(lua_tointeger(L, -2), 1LL);
+        });
+
+        It(TEXT("移除后重新添加只触发新的回调"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Stub = NewObject(UE.UUnLuaTestStub)\
+            local Counter1 = 0\
+            local Counter2 = 0\
+            local Callback1 = function() Counter1 = Counter1 + 1 end\
+            local Callback2 = function() Counter2 = Counter2 + 1 end\
+            Stub.SimpleEvent:Add(Stub, Callback1)\
+            Stub.SimpleEvent:Remove(Stub, Callback1)\
+            Stub.SimpleEvent:Add(Stub, Callback2)\
+            Stub.SimpleEvent:Broadcast()\
+            return Counter1, Counter2\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tointeger(L, -1), 1LL);
+            TEST_EQUAL(lua_tointeger(L, -2), 0LL);
+        });
+
+        It(TEXT("Lua回调直接收到广播参数"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Stub = NewObject(UE.UUnLuaTestStub)\
+            local Result1 = ''\
+            local Result2 = ''\
+            Stub.ParamEvent:Add(Stub, function(self, Value, Text) Result1 = Text .. Value end)\
+            Stub.ParamEvent:Add(Stub, function(self, Value, Text) Result2 = tostring(self == Stub) end)\
+            Stub.ParamEvent:Broadcast(42, 'UnLua')\
+            return Result1, Result2\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(FString(lua_tostring(L, -2)), FString(TEXT("UnLua42")));
+            TEST_EQUAL(FString(lua_tostring(L, -1)), FString(TEXT("true")));
+        });
+
+        It(TEXT("回调中移除自身后不再触发"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Stub = NewObject(UE.UUnLuaTestStub)\
+            local Counter = 0\
+            local Callback\
+            Callback = function() Counter = Counter + 1 Stub.SimpleEvent:Remove(Stub, Callback) end\
+            Stub.SimpleEvent:Add(Stub, Callback)\
+            Stub.SimpleEvent:Broadcast()\
+            Stub.SimpleEvent:Broadcast()\
+            return Counter\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tointeger(L, -1), 1LL);
+        });
+
+        It(TEXT("参数类型不匹配时经UE转换后传给回调"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Stub = NewObject(UE.UUnLuaTestStub)\
+            local Result = ''\
+            Stub.ParamEvent:Add(Stub, function(self, Value, Text) Result = math.type(Value) .. type(Text) end)\
+            Stub.ParamEvent:Broadcast(1.5, 42)\
+            return Result\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(FString(lua_tostring(L, -1)), FString(TEXT("integerstring")));
+        });
+
+        It(TEXT("回调按调用列表的顺序触发"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Stub = NewObject(UE.UUnLuaTestStub)\
+            local Result = ''\
+            local A = function() Result = Result .. 'A' end\
+            local B = function() Result = Result .. 'B' end\
+            local C = function() Result = Result .. 'C' end\
+            Stub.SimpleEvent:Add(Stub, A)\
+            Stub.SimpleEvent:Add(Stub, B)\
+            Stub.SimpleEvent:Add(Stub, C)\
+            Stub.SimpleEvent:Remove(Stub, B)\
+            Stub.SimpleEvent:Add(Stub, B)\
+            Stub.SimpleEvent:Broadcast()\
+            return Result\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(FString(lua_tostring(L, -1)), FString(TEXT("ACB")));
+        });
     });
 
     AfterEach([this]
@@ -154,6 +154,43 @@ void FUnLuaLibObjectSpec::Define()
         });
     });
 
+    Describe(TEXT("GetProperties/SetProperties"), [this]()
+    {
+        It(TEXT("批量读写对象的属性"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Actor = NewObject(UE.AActor)\
+            UE.SetProperties(Actor, {InitialLifeSpan = 5, CustomTimeDilation = 0.5})\
+            local LifeSpan, Dilation, Unknown = UE.GetProperties(Actor, {'InitialLifeSpan', 'CustomTimeDilation', 'NotAProperty'})\
+            local Values = UE.GetProperties(Actor, {'InitialLifeSpan'}, {})\
+            return LifeSpan, Dilation, Unknown, Values.InitialLifeSpan\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tonumber(L, -4), 5.0);
+            TEST_EQUAL(lua_tonumber(L, -3), 0.5);
+            TEST_TRUE(lua_isnil(L, -2));
+            TEST_EQUAL(lua_tonumber(L, -1), 5.0);
+        });
+
+        It(TEXT("跳过名字列表中的非字符串和非属性字段"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Actor = NewObject(UE.AActor)\
+            Actor.InitialLifeSpan = 5\
+            local Values = UE.GetProperties(Actor, {'InitialLifeSpan', 0/0, 1, 'K2_DestroyActor'}, {})\
+            local LifeSpan, NaN, Number, Function = UE.GetProperties(Actor, {'InitialLifeSpan', 0/0, 1, 'K2_DestroyActor'})\
+            return Values.InitialLifeSpan, Values.K2_DestroyActor, LifeSpan, NaN, Number, Function\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tonumber(L, -6), 5.0);
+            TEST_TRUE(lua_isnil(L, -5));
+            TEST_EQUAL(lua_tonumber(L, -4), 5.0);
+            TEST_TRUE(lua_isnil(L, -3));
+            TEST_TRUE(lua_isnil(L, -2));
+            TEST_TRUE(lua_isnil(L, -1));
+        });
+    });
+
     xDescribe(TEXT("Release"), [this]()
     {
         It(TEXT("释放对象在LuaVM的引用"), EAsyncExecution::TaskGraphMainThread, [this]()
@@ -231,6 +231,26 @@ void FUnLuaLibSetSpec::Define()
         });
     });
 
+    Describe(TEXT("元方法"), [this]()
+    {
+        It(TEXT("#Set返回元素数量，pairs遍历所有元素"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "\
+            local Set = UE.TSet(0)\
+            Set:Add(1)\
+            Set:Add(2)\
+            Set:Add(3)\
+            Set:Remove(2)\
+            local Sum = 0\
+            for v, b in pairs(Set) do if b then Sum = Sum + v end end\
+            return #Set, Sum\
+            ";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tointeger(L, -1), 4LL);
+            TEST_EQUAL(lua_tointeger(L, -2), 2LL);
+        });
+    });
+
     AfterEach([this]
     {
         UnLua::Shutdown();
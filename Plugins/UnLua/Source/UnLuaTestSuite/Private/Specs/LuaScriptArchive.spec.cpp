@@ -0,0 +1,81 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#include "UnLua.h"
+#include "LuaScriptArchive.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UnLuaTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(FLuaScriptArchiveSpec, "UnLua.API.LuaScriptArchive", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+    FString ArchivePath;
+END_DEFINE_SPEC(FLuaScriptArchiveSpec)
+
+void FLuaScriptArchiveSpec::Define()
+{
+    BeforeEach([this]
+    {
+        ArchivePath = FPaths::ProjectSavedDir() / TEXT("UnLuaTest.ulpk");
+
+        TArray<FString> Names = {TEXT("Foo.lua"), TEXT("Tests/Bar.lua")};
+        TArray<TArray<uint8>> Scripts;
+        for (const char* Source : {"return 1", "return 'bar'"})
+        {
+            Scripts.Emplace((const uint8*)Source, FCStringAnsi::Strlen(Source));
+        }
+        TArray<uint8> Archive;
+        FLuaScriptArchive::Build(Names, Scripts, Archive);
+        FFileHelper::SaveArrayToFile(Archive, *ArchivePath);
+    });
+
+    AfterEach([this]
+    {
+        IFileManager::Get().Delete(*ArchivePath);
+    });
+
+    It(TEXT("挂载后可以按路径查找脚本，不区分大小写"), EAsyncExecution::TaskGraphMainThread, [this]()
+    {
+        FLuaScriptArchive ScriptArchive;
+        TEST_TRUE(ScriptArchive.Mount(ArchivePath));
+
+        const char* Data = nullptr;
+        int32 Size = 0;
+        TEST_TRUE(ScriptArchive.Find("tests/bar.lua", 13, Data, Size));
+        TEST_EQUAL(FString(Size, Data), FString(TEXT("return 'bar'")));
+        TEST_TRUE(ScriptArchive.Find("FOO.lua", 7, Data, Size));
+        TEST_EQUAL(Size, 8);
+        TEST_FALSE(ScriptArchive.Find("Baz.lua", 7, Data, Size));
+
+        ScriptArchive.Unmount();
+        TEST_FALSE(ScriptArchive.IsMounted());
+        TEST_FALSE(ScriptArchive.Find("Foo.lua", 7, Data, Size));
+    });
+
+    It(TEXT("无效的文件不能挂载"), EAsyncExecution::TaskGraphMainThread, [this]()
+    {
+        const FString InvalidPath = FPaths::ProjectSavedDir() / TEXT("UnLuaTestInvalid.ulpk");
+        FFileHelper::SaveStringToFile(TEXT("return 1"), *InvalidPath);
+        FLuaScriptArchive ScriptArchive;
+        AddExpectedError(TEXT("Invalid Lua script archive"));
+        TEST_FALSE(ScriptArchive.Mount(InvalidPath));
+        TEST_FALSE(ScriptArchive.IsMounted());
+        IFileManager::Get().Delete(*InvalidPath);
+    });
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
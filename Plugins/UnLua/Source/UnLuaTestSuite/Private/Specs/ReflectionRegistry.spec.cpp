@@ -0,0 +1,55 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+#include "UnLuaBase.h"
+#include "ReflectionUtils/ReflectionRegistry.h"
+#include "Misc/AutomationTest.h"
+#include "UnLuaTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(FReflectionRegistrySpec, "UnLua.API.ReflectionRegistry", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+    int32 DummyDescs[2];
+END_DEFINE_SPEC(FReflectionRegistrySpec)
+
+void FReflectionRegistrySpec::Define()
+{
+    Describe(TEXT("Descriptor handles"), [this]()
+    {
+        It(TEXT("句柄可以找到对应的描述符"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            void* Handle = GReflectionRegistry.AddToDescSet(&DummyDescs[0], DESC_FUNCTION);
+            TEST_TRUE(FReflectionRegistry::IsDescHandle(Handle));
+            TEST_FALSE(FReflectionRegistry::IsDescHandle(&DummyDescs[0]));
+            TEST_TRUE(GReflectionRegistry.FindDesc(Handle, DESC_FUNCTION) == &DummyDescs[0]);
+            TEST_TRUE(GReflectionRegistry.FindDesc(Handle, DESC_PROPERTY) == nullptr);
+            GReflectionRegistry.RemoveFromDescSet(&DummyDescs[0]);
+        });
+
+        It(TEXT("描述符释放后旧句柄失效，即使槽位被复用"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            void* OldHandle = GReflectionRegistry.AddToDescSet(&DummyDescs[0], DESC_FUNCTION);
+            GReflectionRegistry.RemoveFromDescSet(&DummyDescs[0]);
+            TEST_TRUE(GReflectionRegistry.FindDesc(OldHandle, DESC_FUNCTION) == nullptr);
+
+            void* NewHandle = GReflectionRegistry.AddToDescSet(&DummyDescs[1], DESC_FUNCTION);
+            TEST_TRUE(OldHandle != NewHandle);
+            TEST_TRUE(GReflectionRegistry.FindDesc(OldHandle, DESC_FUNCTION) == nullptr);
+            TEST_TRUE(GReflectionRegistry.FindDesc(NewHandle, DESC_FUNCTION) == &DummyDescs[1]);
+            GReflectionRegistry.RemoveFromDescSet(&DummyDescs[1]);
+        });
+    });
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
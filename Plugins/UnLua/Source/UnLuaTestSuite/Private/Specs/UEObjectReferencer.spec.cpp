@@ -0,0 +1,90 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+
+#include "UnLua.h"
+#include "LuaCore.h"
+#include "UEObjectReferencer.h"
+#include "Misc/AutomationTest.h"
+#include "UnLuaTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(FObjectReferencerSpec, "UnLua.API.ObjectReferencer", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+    lua_State* L;
+    int32 NumReferencedObjects;
+END_DEFINE_SPEC(FObjectReferencerSpec)
+
+void FObjectReferencerSpec::Define()
+{
+    BeforeEach([this]()
+    {
+        UnLua::Startup();
+        L = UnLua::CreateState();
+        NumReferencedObjects = GObjectReferencer.GetNumReferencedObjects();
+    });
+
+    AfterEach([this]()
+    {
+        UnLua::Shutdown();
+    });
+
+    Describe(TEXT("Batch release"), [this]()
+    {
+        It(TEXT("userdata被Lua GC后引用在批量释放时归还"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            UUnLuaTestStub* Stub = NewObject<UUnLuaTestStub>();
+            UnLua::PushUObject(L, Stub, false);
+            AddUserdataObjectRef(L, Stub);
+            AddUserdataObjectRef(L, Stub);
+            TEST_EQUAL(GObjectReferencer.GetNumReferencedObjects(), NumReferencedObjects + 1);
+
+            lua_pop(L, 1);
+            lua_gc(L, LUA_GCCOLLECT, 0);
+            TEST_EQUAL(GObjectReferencer.GetNumReferencedObjects(), NumReferencedObjects + 1);
+
+            GObjectReferencer.FlushPendingReleases();
+            TEST_EQUAL(GObjectReferencer.GetNumReferencedObjects(), NumReferencedObjects);
+        });
+
+        It(TEXT("未处理的释放在UE GC之前生效，对象可以被回收"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            TWeakObjectPtr<UUnLuaTestStub> Stub = NewObject<UUnLuaTestStub>();
+            GObjectReferencer.AddObjectRef(Stub.Get());
+            CollectGarbage(RF_NoFlags, true);
+            TEST_TRUE(Stub.IsValid());
+
+            GObjectReferencer.NotifyUserdataCollected(Stub.Get(), true);
+            CollectGarbage(RF_NoFlags, true);
+            TEST_FALSE(Stub.IsValid());
+            TEST_EQUAL(GObjectReferencer.GetNumReferencedObjects(), NumReferencedObjects);
+        });
+
+        It(TEXT("释放未处理时对象被删除，队列不会再访问该对象"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            UUnLuaTestStub* Stub = NewObject<UUnLuaTestStub>();
+            GObjectReferencer.AddObjectRef(Stub);
+            GObjectReferencer.NotifyUserdataCollected(Stub, true);
+
+            TEST_TRUE(GObjectReferencer.NotifyUObjectDeleted(Stub));
+            TEST_EQUAL(GObjectReferencer.GetNumReferencedObjects(), NumReferencedObjects);
+
+            GObjectReferencer.FlushPendingReleases();
+            TEST_EQUAL(GObjectReferencer.GetNumReferencedObjects(), NumReferencedObjects);
+            TEST_FALSE(GObjectReferencer.NotifyUObjectDeleted(Stub));
+        });
+    });
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -14,6 +14,9 @@
 
 #include "UnLuaBase.h"
 #include "UnLuaTemplate.h"
+#include "LuaBytecodeCache.h"
+#include "Engine/EngineTypes.h"
+#include "HAL/FileManager.h"
 #include "Misc/AutomationTest.h"
 #include "UnLuaTestHelpers.h"
 
@@ -150,6 +153,54 @@ void FUnLuaBaseSpec::Define()
             UnLua::Push<FVector>(L, &VectorValue);
             TEST_EQUAL(UnLua::Get(L, -1, UnLua::TType<FVector>()), VectorValue);
         });
+
+        It(TEXT("正确传入FString到Lua堆栈，包括非ASCII字符"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const FString Ascii = TEXT("UnLua");
+            const FString NonAscii = TEXT("UnLua字符串");
+            UnLua::Push(L, Ascii);
+            UnLua::Push(L, NonAscii);
+            TEST_EQUAL(UnLua::Get(L, -2, UnLua::TType<FString>()), Ascii);
+            TEST_EQUAL(UnLua::Get(L, -1, UnLua::TType<FString>()), NonAscii);
+            TEST_EQUAL(lua_rawlen(L, -1), (size_t)FTCHARToUTF8(*NonAscii).Length());
+        });
+
+        It(TEXT("正确传入FName到Lua堆栈，重复传入时使用缓存的字符串"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const FName Name = TEXT("UnLuaName");
+            const FName NumberedName(TEXT("UnLuaName"), 3);
+            UnLua::Push(L, Name);
+            UnLua::Push(L, NumberedName);
+            UnLua::Push(L, Name);
+            TEST_EQUAL(FString(lua_tostring(L, -3)), Name.ToString());
+            TEST_EQUAL(FString(lua_tostring(L, -2)), NumberedName.ToString());
+            TEST_TRUE(lua_rawequal(L, -1, -3) != 0);
+        });
+
+        It(TEXT("带编号的FName不进入缓存"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto CountCachedNames = [this]()
+            {
+                int32 Count = 0;
+                lua_getfield(L, LUA_REGISTRYINDEX, "NameCache");
+                lua_pushnil(L);
+                while (lua_next(L, -2) != 0)
+                {
+                    lua_pop(L, 1);
+                    ++Count;
+                }
+                lua_pop(L, 1);
+                return Count;
+            };
+
+            const int32 NumCachedNames = CountCachedNames();
+            for (int32 i = 1; i <= 100; ++i)
+            {
+                UnLua::Push(L, FName(TEXT("UnLuaNumberedName"), i));
+                lua_pop(L, 1);
+            }
+            TEST_EQUAL(CountCachedNames(), NumCachedNames);
+        });
     });
 
     Describe(TEXT("UnLua::RunChunk"), [this]
@@ -307,6 +358,114 @@ void FUnLuaBaseSpec::Define()
         });
     });
 
+#if UNLUA_ENABLE_BYTECODE_CACHE
+    Describe(TEXT("UnLua::LoadChunk"), [this]
+    {
+        static const char* ChunkName = "Tests/BytecodeCacheTest.lua";
+
+        It(TEXT("源码未变时从字节码缓存加载，源码变化后重新编译"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = "return 9527";
+            const char* ModifiedChunk = "return 1024";
+
+            TEST_TRUE(UnLua::LoadChunk(L, Chunk, FCStringAnsi::Strlen(Chunk), ChunkName, "bt", 0, true));
+            TEST_TRUE(UnLua::LoadChunk(L, Chunk, FCStringAnsi::Strlen(Chunk), ChunkName, "bt", 0, true));
+            TEST_TRUE(UnLua::GetModuleLoadStats()[ChunkName].bFromBytecodeCache);
+            lua_call(L, 0, 1);
+            TEST_EQUAL(lua_tointeger(L, -1), 9527LL);
+
+            TEST_TRUE(UnLua::LoadChunk(L, ModifiedChunk, FCStringAnsi::Strlen(ModifiedChunk), ChunkName, "bt", 0, true));
+            TEST_FALSE(UnLua::GetModuleLoadStats()[ChunkName].bFromBytecodeCache);
+            lua_call(L, 0, 1);
+            TEST_EQUAL(lua_tointeger(L, -1), 1024LL);
+        });
+
+        AfterEach([this]
+        {
+            IFileManager::Get().Delete(*GLuaBytecodeCache.GetCacheFilePath(ChunkName), false, false, true);
+        });
+    });
+#endif
+
+    Describe(TEXT("UnLua::SetEagerClassRegistration"), [this]
+    {
+        It(TEXT("预先填充元表后访问字段不再走慢路径"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            UnLua::SetEagerClassRegistration(FHitResult::StaticStruct());
+            UnLua::RunChunk(L, "local HitResult = UE.FHitResult()");
+            const uint32 NumSlowPathHits = UnLua::GetNumFieldSlowPathHits();
+
+            const auto Chunk = R"(
+            local HitResult = UE.FHitResult()
+            local Time = HitResult.Time
+            local Distance = HitResult.Distance
+            HitResult.Time = 0.5
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(UnLua::GetNumFieldSlowPathHits(), NumSlowPathHits);
+
+            UnLua::SetEagerClassRegistration(FHitResult::StaticStruct(), false);
+        });
+    });
+
+    Describe(TEXT("UnLua::PushUObject"), [this]
+    {
+        It(TEXT("重复传入同一个对象时复用缓存的userdata并统计命中次数"), EAsyncExecution::TaskGraphMainThread, [this]
+        {
+            const int32 N = 10000;
+            TArray<UObject*> Objects;
+            for (int32 i = 0; i < N; ++i)
+            {
+                Objects.Add(NewObject<UUnLuaTestStub>());
+            }
+
+            lua_gc(L, LUA_GCSTOP);      // keep the cached userdata alive in the weak 'ObjectMap'
+
+            uint32 OldHits, OldMisses;
+            UnLua::GetPushUObjectStats(OldHits, OldMisses);
+
+            double StartTime = FPlatformTime::Seconds();
+            for (UObject* Object : Objects)
+            {
+                UnLua::PushUObject(L, Object, false);
+                lua_pop(L, 1);
+            }
+            const double MissTime = FPlatformTime::Seconds() - StartTime;
+
+            StartTime = FPlatformTime::Seconds();
+            for (UObject* Object : Objects)
+            {
+                UnLua::PushUObject(L, Object, false);
+                lua_pop(L, 1);
+            }
+            const double HitTime = FPlatformTime::Seconds() - StartTime;
+
+            StartTime = FPlatformTime::Seconds();
+            for (UObject* Object : Objects)
+            {
+                UnLua::PushUObjectFast(L, Object, false);
+                lua_pop(L, 1);
+            }
+            const double FastHitTime = FPlatformTime::Seconds() - StartTime;
+
+            uint32 Hits, Misses;
+            UnLua::GetPushUObjectStats(Hits, Misses);
+            TEST_EQUAL(Misses - OldMisses, (uint32)N);
+            TEST_EQUAL(Hits - OldHits, (uint32)N * 2);
+
+            UnLua::PushUObject(L, Objects[0], false);
+            UnLua::PushUObjectFast(L, Objects[0], false);
+            TEST_TRUE(lua_rawequal(L, -1, -2) != 0);
+
+            lua_gc(L, LUA_GCRESTART);
+
+            const double Multiplier = 1000000000.0 / N;
+            AddInfo(FString::Printf(TEXT("PushUObject miss ; %f"), MissTime * Multiplier));
+            AddInfo(FString::Printf(TEXT("PushUObject hit ; %f"), HitTime * Multiplier));
+            AddInfo(FString::Printf(TEXT("PushUObjectFast hit ; %f"), FastHitTime * Multiplier));
+        });
+    });
+
     AfterEach([this]
     {
         UnLua::Shutdown();
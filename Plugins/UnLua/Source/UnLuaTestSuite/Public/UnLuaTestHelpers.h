@@ -18,6 +18,7 @@
 #include "GameFramework/Actor.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "UnLua.h"
+#include "UnLuaInterface.h"
 #include "UnLuaTestHelpers.generated.h"
 
 namespace UnLuaTestHelpers
@@ -26,6 +27,8 @@ namespace UnLuaTestHelpers
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FUnLuaTestSimpleEvent);
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FUnLuaTestParamEvent, int32, Value, const FString&, Text);
+
 DECLARE_DYNAMIC_DELEGATE(FUnLuaTestSimpleHandler);
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FIssue304Event, TArray<FString>, Array);
@@ -49,6 +52,9 @@ public:
     UPROPERTY()
     FUnLuaTestSimpleEvent SimpleEvent;
 
+    UPROPERTY()
+    FUnLuaTestParamEvent ParamEvent;
+
     UPROPERTY()
     FUnLuaTestSimpleHandler SimpleHandler;
 
@@ -65,6 +71,15 @@ public:
     void AddCount() { Counter++; }
 };
 
+UCLASS()
+class UNLUATESTSUITE_API UUnLuaTestBindStub : public UObject, public IUnLuaInterface
+{
+    GENERATED_BODY()
+
+public:
+    virtual FString GetModuleName_Implementation() const override { return TEXT("UnLuaTestBindStub"); }
+};
+
 UCLASS()
 class UNLUATESTSUITE_API AUnLuaTestActor : public AActor
 {